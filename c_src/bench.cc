@@ -0,0 +1,329 @@
+// Standalone benchmark harness for the native index layer.
+//
+// Builds synthetic clustered datasets, then for each index factory
+// string measures add throughput and, for each thread count and
+// query batch size, search QPS, p50/p99 batch latency and recall@k
+// against exact Flat ground truth. The queries are searched in full
+// passes until at least --min-batches batches were timed, so latency
+// percentiles of large batch sizes are not computed from a handful
+// of samples. Results are printed as one JSON object per line so runs
+// can be diffed across commits.
+//
+// Usage: ex_faiss_bench [--nb N] [--nq N] [--d N] [--k N] [--seed N]
+//                       [--threads 1,8] [--batch-sizes 1,64,1000]
+//                       [--min-batches 100]
+//                       [--commit SHA] [--faiss-rev SHA]
+//                       [--index "IVF256,Flat@nprobe=16"]...
+//
+// An index spec is a factory string optionally followed by `@` and
+// Faiss ParameterSpace search parameters. --index may be repeated.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <omp.h>
+#include <faiss/AutoTune.h>
+
+#include "ex_faiss/index.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  int64_t nb = 100000;
+  int64_t nq = 1000;
+  int d = 128;
+  int64_t k = 10;
+  unsigned seed = 1234;
+  int64_t min_batches = 100;
+  // Tags for comparing results across commits, passed at run time
+  // so a cached binary never reports a stale revision
+  std::string commit = "unknown";
+  std::string faiss_rev = "unknown";
+  std::vector<int> threads;
+  std::vector<int64_t> batch_sizes = {1, 16, 256, 1000};
+  std::vector<std::string> indices;
+};
+
+std::vector<std::string> Split(const std::string& str, char sep) {
+  std::vector<std::string> parts;
+  size_t start = 0;
+  while (start <= str.size()) {
+    size_t end = str.find(sep, start);
+    if (end == std::string::npos) end = str.size();
+    if (end > start) parts.push_back(str.substr(start, end - start));
+    start = end + 1;
+  }
+  return parts;
+}
+
+template <typename T>
+std::vector<T> ParseIntList(const std::string& str) {
+  std::vector<T> values;
+  for (const std::string& part : Split(str, ',')) {
+    values.push_back(static_cast<T>(std::atoll(part.c_str())));
+  }
+  return values;
+}
+
+void CheckPositive(const char * option, int64_t value) {
+  if (value <= 0) {
+    std::fprintf(stderr, "%s must be positive, got %lld\n", option, static_cast<long long>(value));
+    std::exit(1);
+  }
+}
+
+Options ParseOptions(int argc, char ** argv) {
+  Options opts;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (i + 1 >= argc) {
+      std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+      std::exit(1);
+    }
+    std::string value = argv[++i];
+
+    if (arg == "--nb") {
+      opts.nb = std::atoll(value.c_str());
+    } else if (arg == "--nq") {
+      opts.nq = std::atoll(value.c_str());
+    } else if (arg == "--d") {
+      opts.d = std::atoi(value.c_str());
+    } else if (arg == "--k") {
+      opts.k = std::atoll(value.c_str());
+    } else if (arg == "--seed") {
+      opts.seed = std::atoi(value.c_str());
+    } else if (arg == "--threads") {
+      opts.threads = ParseIntList<int>(value);
+    } else if (arg == "--batch-sizes") {
+      opts.batch_sizes = ParseIntList<int64_t>(value);
+    } else if (arg == "--min-batches") {
+      opts.min_batches = std::atoll(value.c_str());
+    } else if (arg == "--commit") {
+      opts.commit = value;
+    } else if (arg == "--faiss-rev") {
+      opts.faiss_rev = value;
+    } else if (arg == "--index") {
+      opts.indices.push_back(value);
+    } else {
+      std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+      std::exit(1);
+    }
+  }
+
+  CheckPositive("--nb", opts.nb);
+  CheckPositive("--nq", opts.nq);
+  CheckPositive("--d", opts.d);
+  CheckPositive("--k", opts.k);
+  CheckPositive("--min-batches", opts.min_batches);
+  for (int threads : opts.threads) CheckPositive("--threads", threads);
+  for (int64_t batch_size : opts.batch_sizes) CheckPositive("--batch-sizes", batch_size);
+
+  if (opts.batch_sizes.empty()) {
+    std::fprintf(stderr, "--batch-sizes must not be empty\n");
+    std::exit(1);
+  }
+
+  if (opts.threads.empty()) {
+    int max_threads = omp_get_max_threads();
+    opts.threads = {1};
+    if (max_threads > 1) opts.threads.push_back(max_threads);
+  }
+
+  if (opts.indices.empty()) {
+    opts.indices = {
+      "Flat",
+      "IVF1024,Flat@nprobe=16",
+      "IVF1024,PQ32@nprobe=16",
+      "HNSW32,Flat@efSearch=64",
+      "PQ32"
+    };
+  }
+
+  return opts;
+}
+
+// Gaussian blobs around random centroids, which gives IVF and
+// HNSW a realistic structure to exploit, unlike uniform noise.
+void GenerateClustered(std::mt19937& rng,
+                       const std::vector<float>& centroids,
+                       int d,
+                       int64_t n,
+                       std::vector<float>& out) {
+  int64_t n_centroids = centroids.size() / d;
+  std::uniform_int_distribution<int64_t> pick(0, n_centroids - 1);
+  std::normal_distribution<float> noise(0.0f, 0.1f);
+
+  out.resize(n * d);
+  for (int64_t i = 0; i < n; i++) {
+    const float * c = centroids.data() + pick(rng) * d;
+    for (int j = 0; j < d; j++) {
+      out[i * d + j] = c[j] + noise(rng);
+    }
+  }
+}
+
+double Seconds(Clock::duration duration) {
+  return std::chrono::duration<double>(duration).count();
+}
+
+double Percentile(std::vector<double> values, double p) {
+  if (values.empty()) return 0.0;
+  std::sort(values.begin(), values.end());
+  size_t rank = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+  return values[rank];
+}
+
+double RecallAtK(const std::vector<int64_t>& labels,
+                 const std::vector<int64_t>& ground_truth,
+                 int64_t nq,
+                 int64_t k) {
+  int64_t found = 0;
+  for (int64_t q = 0; q < nq; q++) {
+    std::unordered_set<int64_t> expected(ground_truth.begin() + q * k,
+                                         ground_truth.begin() + (q + 1) * k);
+    for (int64_t j = 0; j < k; j++) {
+      if (expected.count(labels[q * k + j])) found++;
+    }
+  }
+  return static_cast<double>(found) / (nq * k);
+}
+
+// Index specs are user supplied and may contain quotes
+std::string JsonString(const std::string& str) {
+  std::string out = "\"";
+  for (char c : str) {
+    if (c == '"' || c == '\\') out += '\\';
+    out += c;
+  }
+  return out + "\"";
+}
+
+void PrintHeader(const Options& opts, const std::string& spec, const char * op) {
+  std::printf("{\"commit\":%s,\"faiss_rev\":%s,\"index\":%s,\"op\":\"%s\","
+              "\"nb\":%lld,\"nq\":%lld,\"d\":%d,\"k\":%lld",
+              JsonString(opts.commit).c_str(),
+              JsonString(opts.faiss_rev).c_str(),
+              JsonString(spec).c_str(),
+              op,
+              static_cast<long long>(opts.nb),
+              static_cast<long long>(opts.nq),
+              opts.d,
+              static_cast<long long>(opts.k));
+}
+
+void RunIndex(const Options& opts,
+              const std::string& spec,
+              const std::vector<float>& xb,
+              const std::vector<float>& xq,
+              const std::vector<int64_t>& ground_truth) {
+  std::vector<std::string> parts = Split(spec, '@');
+  std::string factory = parts.empty() ? spec : parts[0];
+
+  omp_set_num_threads(opts.threads.back());
+
+  std::unique_ptr<ex_faiss::ExFaissIndex> index(
+    new ex_faiss::ExFaissIndex(opts.d, factory.c_str(), faiss::METRIC_L2));
+
+  Clock::time_point start = Clock::now();
+  index->Train(opts.nb, xb.data());
+  double train_seconds = Seconds(Clock::now() - start);
+
+  start = Clock::now();
+  index->Add(opts.nb, xb.data());
+  double add_seconds = Seconds(Clock::now() - start);
+
+  PrintHeader(opts, spec, "add");
+  std::printf(",\"threads\":%d,\"train_seconds\":%.6f,\"add_seconds\":%.6f,"
+              "\"vectors_per_second\":%.1f}\n",
+              opts.threads.back(), train_seconds, add_seconds, opts.nb / add_seconds);
+
+  if (parts.size() > 1) {
+    faiss::ParameterSpace().set_index_parameters(index->index(), parts[1].c_str());
+  }
+
+  std::vector<float> distances(opts.nq * opts.k);
+  std::vector<int64_t> labels(opts.nq * opts.k);
+
+  for (int threads : opts.threads) {
+    omp_set_num_threads(threads);
+
+    for (int64_t batch_size : opts.batch_sizes) {
+      // Whole passes over the queries, so every pass computes the
+      // same labels and recall is unaffected by repetition
+      int64_t batches_per_pass = (opts.nq + batch_size - 1) / batch_size;
+      int64_t passes = (opts.min_batches + batches_per_pass - 1) / batches_per_pass;
+
+      std::vector<double> latencies;
+      latencies.reserve(passes * batches_per_pass);
+      start = Clock::now();
+
+      for (int64_t pass = 0; pass < passes; pass++) {
+        for (int64_t i0 = 0; i0 < opts.nq; i0 += batch_size) {
+          int64_t n = std::min(batch_size, opts.nq - i0);
+          Clock::time_point batch_start = Clock::now();
+          index->Search(n,
+                        xq.data() + i0 * opts.d,
+                        opts.k,
+                        distances.data() + i0 * opts.k,
+                        labels.data() + i0 * opts.k);
+          latencies.push_back(Seconds(Clock::now() - batch_start));
+        }
+      }
+
+      double total = Seconds(Clock::now() - start);
+
+      PrintHeader(opts, spec, "search");
+      std::printf(",\"threads\":%d,\"batch_size\":%lld,\"samples\":%lld,\"qps\":%.1f,"
+                  "\"p50_us\":%.1f,\"p99_us\":%.1f,\"recall_at_k\":%.4f}\n",
+                  threads,
+                  static_cast<long long>(batch_size),
+                  static_cast<long long>(latencies.size()),
+                  passes * opts.nq / total,
+                  Percentile(latencies, 0.50) * 1e6,
+                  Percentile(latencies, 0.99) * 1e6,
+                  RecallAtK(labels, ground_truth, opts.nq, opts.k));
+      std::fflush(stdout);
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char ** argv) {
+  Options opts = ParseOptions(argc, argv);
+  std::mt19937 rng(opts.seed);
+
+  int64_t n_centroids = std::max<int64_t>(1, opts.nb / 1000);
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+  std::vector<float> centroids(n_centroids * opts.d);
+  for (float& x : centroids) x = uniform(rng);
+
+  std::vector<float> xb, xq;
+  GenerateClustered(rng, centroids, opts.d, opts.nb, xb);
+  GenerateClustered(rng, centroids, opts.d, opts.nq, xq);
+
+  std::vector<int64_t> ground_truth(opts.nq * opts.k);
+  {
+    ex_faiss::ExFaissIndex flat(opts.d, "Flat", faiss::METRIC_L2);
+    flat.Add(opts.nb, xb.data());
+    std::vector<float> distances(opts.nq * opts.k);
+    flat.Search(opts.nq, xq.data(), opts.k, distances.data(), ground_truth.data());
+  }
+
+  for (const std::string& spec : opts.indices) {
+    RunIndex(opts, spec, xb, xq, ground_truth);
+  }
+
+  return 0;
+}
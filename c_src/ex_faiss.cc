@@ -4,6 +4,7 @@
 #include "ex_faiss/nif_util.h"
 #include "ex_faiss/index.h"
 #include "ex_faiss/clustering.h"
+#include "ex_faiss/thread_pool.h"
 
 #if defined(__CUDA__)
 #include <faiss/gpu/utils/DeviceUtils.h>
@@ -44,6 +45,27 @@ static int load(ErlNifEnv* env, void ** priv, ERL_NIF_TERM load_info) {
   return 0;
 }
 
+// Workers of the multi-index search pool must not outlive the
+// library code they run
+static void unload(ErlNifEnv* env, void * priv) {
+  ex_faiss::ThreadPool::Shutdown();
+}
+
+// Records the time between the caller issuing the NIF call, given
+// as its :erlang.monotonic_time/0, and the operation starting to
+// execute. This covers dirty scheduler queueing and argument decoding.
+static void record_wait(ex_faiss::ExFaissIndex * index, ex_faiss::Operation op, int64_t enqueued_at) {
+  index->stats().op(op).wait.Record(nif::nanoseconds_since(enqueued_at));
+}
+
+static ERL_NIF_TERM make_histogram(ErlNifEnv * env, const ex_faiss::LatencyHistogram& histogram) {
+  return nif::make_map(env, {
+    {"count", nif::make(env, histogram.count())},
+    {"total_ns", nif::make(env, histogram.total_ns())},
+    {"buckets", nif::make_list(env, histogram.buckets())}
+  });
+}
+
 ERL_NIF_TERM new_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 3) {
     nif::error(env, "Bad argument count.");
@@ -82,6 +104,28 @@ ERL_NIF_TERM clone_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
   return nif::ok(env, nif::make<ex_faiss::ExFaissIndex *>(env, cloned));
 }
 
+ERL_NIF_TERM replicate_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) {
+    return nif::error(env, "Bad argument count.");
+  }
+
+  ex_faiss::ExFaissIndex ** index;
+
+  if (!nif::get<ex_faiss::ExFaissIndex *>(env, argv[0], index)) {
+    return nif::error(env, "Unable to get index.");
+  }
+
+  ex_faiss::ExFaissIndex * replicated;
+
+  try {
+    replicated = (*index)->CloneReplicated();
+  } catch (const std::exception& e) {
+    return nif::error(env, e.what());
+  }
+
+  return nif::ok(env, nif::make<ex_faiss::ExFaissIndex *>(env, replicated));
+}
+
 ERL_NIF_TERM write_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 2) {
     return nif::error(env, "Bad argument count.");
@@ -123,13 +167,14 @@ ERL_NIF_TERM read_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
 }
 
 ERL_NIF_TERM add_to_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 3) {
+  if (argc != 4) {
     return nif::error(env, "Bad argument count.");
   }
 
   ex_faiss::ExFaissIndex ** index;
   int64_t n;
   ErlNifBinary data;
+  int64_t enqueued_at;
 
   if (!nif::get<ex_faiss::ExFaissIndex *>(env, argv[0], index)) {
     return nif::error(env, "Unable to get index.");
@@ -140,14 +185,21 @@ ERL_NIF_TERM add_to_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[])
   if (!nif::get_binary(env, argv[2], &data)) {
     return nif::error(env, "Unable to get data.");
   }
+  if (!nif::get(env, argv[3], &enqueued_at)) {
+    return nif::error(env, "Unable to get enqueued time.");
+  }
+  if ((*index)->replicated()) {
+    return nif::error(env, "Replicated indices are read-only.");
+  }
 
+  record_wait(*index, ex_faiss::kAdd, enqueued_at);
   (*index)->Add(n, reinterpret_cast<float *>(data.data));
 
   return nif::ok(env);
 }
 
 ERL_NIF_TERM add_with_ids_to_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 4) {
+  if (argc != 5) {
     return nif::error(env, "Bad argument count.");
   }
 
@@ -155,6 +207,7 @@ ERL_NIF_TERM add_with_ids_to_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM
   int64_t n;
   ErlNifBinary data;
   ErlNifBinary ids;
+  int64_t enqueued_at;
 
   if (!nif::get<ex_faiss::ExFaissIndex *>(env, argv[0], index)) {
     return nif::error(env, "Unable to get index.");
@@ -168,14 +221,21 @@ ERL_NIF_TERM add_with_ids_to_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM
   if (!nif::get_binary(env, argv[3], &ids)) {
     return nif::error(env, "Unable to get ids.");
   }
+  if (!nif::get(env, argv[4], &enqueued_at)) {
+    return nif::error(env, "Unable to get enqueued time.");
+  }
+  if ((*index)->replicated()) {
+    return nif::error(env, "Replicated indices are read-only.");
+  }
 
+  record_wait(*index, ex_faiss::kAdd, enqueued_at);
   (*index)->AddWithIds(n, reinterpret_cast<float *>(data.data), reinterpret_cast<int64_t *>(ids.data));
 
   return nif::ok(env);
 }
 
 ERL_NIF_TERM search_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 4) {
+  if (argc != 5) {
     return nif::error(env, "Bad argument count.");
   }
 
@@ -183,6 +243,7 @@ ERL_NIF_TERM search_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[])
   int64_t n;
   ErlNifBinary data;
   int64_t k;
+  int64_t enqueued_at;
 
   if (!nif::get<ex_faiss::ExFaissIndex *>(env, argv[0], index)) {
     return nif::error(env, "Unable to get index.");
@@ -196,6 +257,11 @@ ERL_NIF_TERM search_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[])
   if (!nif::get(env, argv[3], &k)) {
     return nif::error(env, "Unable to get k.");
   }
+  if (!nif::get(env, argv[4], &enqueued_at)) {
+    return nif::error(env, "Unable to get enqueued time.");
+  }
+
+  record_wait(*index, ex_faiss::kSearch, enqueued_at);
 
   ErlNifBinary distances, labels;
   enif_alloc_binary(n * k * sizeof(float), &distances);
@@ -213,14 +279,118 @@ ERL_NIF_TERM search_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[])
   return nif::ok(env, enif_make_tuple2(env, distances_term, labels_term));
 }
 
+ERL_NIF_TERM multi_search_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 6) {
+    return nif::error(env, "Bad argument count.");
+  }
+
+  std::vector<ex_faiss::ExFaissIndex *> indices;
+  int64_t n;
+  ErlNifBinary data;
+  int64_t k;
+  int32_t merge;
+  int64_t enqueued_at;
+
+  ERL_NIF_TERM head, tail = argv[0];
+  while (enif_get_list_cell(env, tail, &head, &tail)) {
+    ex_faiss::ExFaissIndex ** index;
+    if (!nif::get<ex_faiss::ExFaissIndex *>(env, head, index)) {
+      return nif::error(env, "Unable to get index.");
+    }
+    indices.push_back(*index);
+  }
+  if (indices.empty()) {
+    return nif::error(env, "Unable to get indices.");
+  }
+  if (!nif::get(env, argv[1], &n)) {
+    return nif::error(env, "Unable to get n.");
+  }
+  if (!nif::get_binary(env, argv[2], &data)) {
+    return nif::error(env, "Unable to get data.");
+  }
+  if (!nif::get(env, argv[3], &k)) {
+    return nif::error(env, "Unable to get k.");
+  }
+  if (!nif::get(env, argv[4], &merge)) {
+    return nif::error(env, "Unable to get merge.");
+  }
+  if (!nif::get(env, argv[5], &enqueued_at)) {
+    return nif::error(env, "Unable to get enqueued time.");
+  }
+
+  faiss::MetricType metric_type = indices[0]->index()->metric_type;
+  for (ex_faiss::ExFaissIndex * index : indices) {
+    if (index->dim() != indices[0]->dim()) {
+      return nif::error(env, "Indices must have the same dimensionality.");
+    }
+    // Distances of different metrics are on different scales
+    if (merge && index->index()->metric_type != metric_type) {
+      return nif::error(env, "Merged indices must have the same metric.");
+    }
+    record_wait(index, ex_faiss::kSearch, enqueued_at);
+  }
+
+  int64_t num_indices = indices.size();
+  std::vector<float> distances(num_indices * n * k);
+  std::vector<int64_t> labels(num_indices * n * k);
+
+  try {
+    ex_faiss::MultiSearch(indices,
+                          n,
+                          reinterpret_cast<float *>(data.data),
+                          k,
+                          distances.data(),
+                          labels.data());
+  } catch (const std::exception& e) {
+    return nif::error(env, e.what());
+  }
+
+  if (merge) {
+    ErlNifBinary merged_distances, merged_labels, tenants;
+    enif_alloc_binary(n * k * sizeof(float), &merged_distances);
+    enif_alloc_binary(n * k * sizeof(int64_t), &merged_labels);
+    enif_alloc_binary(n * k * sizeof(int32_t), &tenants);
+
+    ex_faiss::MergeSearchResults(num_indices,
+                                 n,
+                                 k,
+                                 metric_type,
+                                 distances.data(),
+                                 labels.data(),
+                                 reinterpret_cast<float *>(merged_distances.data),
+                                 reinterpret_cast<int64_t *>(merged_labels.data),
+                                 reinterpret_cast<int32_t *>(tenants.data));
+
+    return nif::ok(env, enif_make_tuple3(env,
+                                         nif::make(env, merged_distances),
+                                         nif::make(env, merged_labels),
+                                         nif::make(env, tenants)));
+  }
+
+  std::vector<ERL_NIF_TERM> results;
+  results.reserve(num_indices);
+
+  for (int64_t i = 0; i < num_indices; i++) {
+    ERL_NIF_TERM distances_term, labels_term;
+    unsigned char * distances_data = enif_make_new_binary(env, n * k * sizeof(float), &distances_term);
+    unsigned char * labels_data = enif_make_new_binary(env, n * k * sizeof(int64_t), &labels_term);
+    std::memcpy(distances_data, distances.data() + i * n * k, n * k * sizeof(float));
+    std::memcpy(labels_data, labels.data() + i * n * k, n * k * sizeof(int64_t));
+    results.push_back(enif_make_tuple2(env, distances_term, labels_term));
+  }
+
+  return nif::ok(env, enif_make_list_from_array(env, results.data(), results.size()));
+}
+
 ERL_NIF_TERM train_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 3) {
+  if (argc != 4) {
     return nif::error(env, "Bad argument count.");
   }
 
   ex_faiss::ExFaissIndex ** index;
   int64_t n;
   ErlNifBinary data;
+  int64_t enqueued_at;
 
   if (!nif::get<ex_faiss::ExFaissIndex *>(env, argv[0], index)) {
     return nif::error(env, "Unable to get index.");
@@ -231,20 +401,28 @@ ERL_NIF_TERM train_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
   if (!nif::get_binary(env, argv[2], &data)) {
     return nif::error(env, "Unable to get data.");
   }
+  if (!nif::get(env, argv[3], &enqueued_at)) {
+    return nif::error(env, "Unable to get enqueued time.");
+  }
+  if ((*index)->replicated()) {
+    return nif::error(env, "Replicated indices are read-only.");
+  }
 
+  record_wait(*index, ex_faiss::kTrain, enqueued_at);
   (*index)->Train(n, reinterpret_cast<float *>(data.data));
 
   return nif::ok(env);
 }
 
 ERL_NIF_TERM reconstruct_batch_from_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 3) {
+  if (argc != 4) {
     return nif::error(env, "Bad argument count.");
   }
 
   ex_faiss::ExFaissIndex ** index;
   int64_t n;
   ErlNifBinary keys;
+  int64_t enqueued_at;
 
   if (!nif::get<ex_faiss::ExFaissIndex *>(env, argv[0], index)) {
     return nif::error(env, "Unable to get index.");
@@ -255,13 +433,66 @@ ERL_NIF_TERM reconstruct_batch_from_index(ErlNifEnv * env, int argc, const ERL_N
   if (!nif::get_binary(env, argv[2], &keys)) {
     return nif::error(env, "Unable to get keys.");
   }
+  if (!nif::get(env, argv[3], &enqueued_at)) {
+    return nif::error(env, "Unable to get enqueued time.");
+  }
+
+  record_wait(*index, ex_faiss::kReconstruct, enqueued_at);
 
   int64_t d = (*index)->dim();
 
   ErlNifBinary reconstruction;
   enif_alloc_binary(n * d * sizeof(float), &reconstruction);
 
-  (*index)->ReconstructBatch(n, reinterpret_cast<int64_t *>(keys.data), reinterpret_cast<float *>(reconstruction.data));
+  try {
+    (*index)->ReconstructBatch(n, reinterpret_cast<int64_t *>(keys.data), reinterpret_cast<float *>(reconstruction.data));
+  } catch (const std::exception& e) {
+    enif_release_binary(&reconstruction);
+    return nif::error(env, e.what());
+  }
+
+  return nif::ok(env, nif::make(env, reconstruction));
+}
+
+ERL_NIF_TERM reconstruct_range_from_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 4) {
+    return nif::error(env, "Bad argument count.");
+  }
+
+  ex_faiss::ExFaissIndex ** index;
+  int64_t i0;
+  int64_t n;
+  int64_t enqueued_at;
+
+  if (!nif::get<ex_faiss::ExFaissIndex *>(env, argv[0], index)) {
+    return nif::error(env, "Unable to get index.");
+  }
+  if (!nif::get(env, argv[1], &i0)) {
+    return nif::error(env, "Unable to get i0.");
+  }
+  if (!nif::get(env, argv[2], &n)) {
+    return nif::error(env, "Unable to get n.");
+  }
+  if (!nif::get(env, argv[3], &enqueued_at)) {
+    return nif::error(env, "Unable to get enqueued time.");
+  }
+  if (i0 < 0 || n < 0 || i0 > (*index)->n_total() || n > (*index)->n_total() - i0) {
+    return nif::error(env, "Range out of bounds.");
+  }
+
+  record_wait(*index, ex_faiss::kReconstruct, enqueued_at);
+
+  int64_t d = (*index)->dim();
+
+  ErlNifBinary reconstruction;
+  enif_alloc_binary(n * d * sizeof(float), &reconstruction);
+
+  try {
+    (*index)->ReconstructRange(i0, n, reinterpret_cast<float *>(reconstruction.data));
+  } catch (const std::exception& e) {
+    enif_release_binary(&reconstruction);
+    return nif::error(env, e.what());
+  }
 
   return nif::ok(env, nif::make(env, reconstruction));
 }
@@ -294,10 +525,15 @@ ERL_NIF_TERM compute_residuals_from_index(ErlNifEnv * env, int argc, const ERL_N
   ErlNifBinary residuals;
   enif_alloc_binary(n * d * sizeof(float), &residuals);
 
-  (*index)->ComputeResiduals(n, 
-                             reinterpret_cast<float *>(data.data),
-                             reinterpret_cast<float *>(residuals.data),
-                             reinterpret_cast<int64_t *>(keys.data));
+  try {
+    (*index)->ComputeResiduals(n,
+                               reinterpret_cast<float *>(data.data),
+                               reinterpret_cast<float *>(residuals.data),
+                               reinterpret_cast<int64_t *>(keys.data));
+  } catch (const std::exception& e) {
+    enif_release_binary(&residuals);
+    return nif::error(env, e.what());
+  }
 
   return nif::ok(env, nif::make(env, residuals));
 }
@@ -312,6 +548,9 @@ ERL_NIF_TERM reset_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
   if (!nif::get<ex_faiss::ExFaissIndex *>(env, argv[0], index)) {
     return nif::error(env, "Unable to get index.");
   }
+  if ((*index)->replicated()) {
+    return nif::error(env, "Replicated indices are read-only.");
+  }
 
   (*index)->Reset();
 
@@ -350,6 +589,262 @@ ERL_NIF_TERM get_index_n_vectors(ErlNifEnv * env, int argc, const ERL_NIF_TERM a
   return nif::ok(env, nif::make(env, n_total));
 }
 
+ERL_NIF_TERM get_index_info(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) {
+    return nif::error(env, "Bad argument count.");
+  }
+
+  ex_faiss::ExFaissIndex ** index;
+
+  if (!nif::get<ex_faiss::ExFaissIndex *>(env, argv[0], index)) {
+    return nif::error(env, "Unable to get index.");
+  }
+
+  ex_faiss::ExFaissIndexInfo info = (*index)->Info();
+  ERL_NIF_TERM nil = nif::atom(env, "nil");
+
+  ERL_NIF_TERM ivf_term = nil;
+  if (info.is_ivf) {
+    ERL_NIF_TERM list_sizes_term = nif::make_map(env, {
+      {"min", nif::make(env, info.ivf.list_size_min)},
+      {"max", nif::make(env, info.ivf.list_size_max)},
+      {"p50", nif::make(env, info.ivf.list_size_p50)},
+      {"p90", nif::make(env, info.ivf.list_size_p90)},
+      {"p99", nif::make(env, info.ivf.list_size_p99)}
+    });
+
+    ivf_term = nif::make_map(env, {
+      {"nlist", nif::make(env, info.ivf.nlist)},
+      {"nprobe", nif::make(env, info.ivf.nprobe)},
+      {"list_sizes", list_sizes_term},
+      {"imbalance_factor", nif::make(env, info.ivf.imbalance_factor)}
+    });
+  }
+
+  ERL_NIF_TERM hnsw_term = nil;
+  if (info.is_hnsw) {
+    hnsw_term = nif::make_map(env, {
+      {"max_level", nif::make(env, info.hnsw.max_level)},
+      {"entry_point", nif::make(env, info.hnsw.entry_point)},
+      {"ef_search", nif::make(env, info.hnsw.ef_search)},
+      {"ef_construction", nif::make(env, info.hnsw.ef_construction)},
+      {"levels", nif::make_list(env, info.hnsw.levels)}
+    });
+  }
+
+  ERL_NIF_TERM info_term = nif::make_map(env, {
+    {"class", nif::make_string(env, info.class_name)},
+    {"dim", nif::make(env, (*index)->dim())},
+    {"n_vectors", nif::make(env, (*index)->n_total())},
+    {"replicas", nif::make(env, (*index)->num_replicas())},
+    {"is_trained", nif::make(env, info.is_trained)},
+    {"metric", nif::make(env, static_cast<int>(info.metric_type))},
+    {"sa_code_size", info.sa_code_size < 0 ? nil : nif::make(env, info.sa_code_size)},
+    {"bytes", info.total_bytes < 0 ? nil : nif::make(env, info.total_bytes)},
+    {"ivf", ivf_term},
+    {"hnsw", hnsw_term}
+  });
+
+  return nif::ok(env, info_term);
+}
+
+ERL_NIF_TERM get_index_stats(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) {
+    return nif::error(env, "Bad argument count.");
+  }
+
+  ex_faiss::ExFaissIndex ** index;
+
+  if (!nif::get<ex_faiss::ExFaissIndex *>(env, argv[0], index)) {
+    return nif::error(env, "Unable to get index.");
+  }
+
+  ex_faiss::ExFaissIndexStats& stats = (*index)->stats();
+  std::vector<std::pair<const char *, ERL_NIF_TERM>> pairs;
+
+  for (int i = 0; i < ex_faiss::kNumOperations; i++) {
+    ex_faiss::Operation op = static_cast<ex_faiss::Operation>(i);
+    ex_faiss::OperationStats& op_stats = stats.op(op);
+    int64_t items = op_stats.items.load(std::memory_order_relaxed);
+
+    ERL_NIF_TERM op_term = nif::make_map(env, {
+      {"items", nif::make(env, items)},
+      {"exec", make_histogram(env, op_stats.exec)},
+      {"wait", make_histogram(env, op_stats.wait)}
+    });
+    pairs.push_back({ex_faiss::OperationName(op), op_term});
+  }
+
+  ex_faiss::FaissSearchCounters& counters = stats.faiss_counters();
+
+  pairs.push_back({"ivf", nif::make_map(env, {
+    {"nq", nif::make(env, counters.ivf_nq.load(std::memory_order_relaxed))},
+    {"nlist", nif::make(env, counters.ivf_nlist.load(std::memory_order_relaxed))},
+    {"ndis", nif::make(env, counters.ivf_ndis.load(std::memory_order_relaxed))},
+    {"nheap_updates", nif::make(env, counters.ivf_nheap_updates.load(std::memory_order_relaxed))}
+  })});
+  pairs.push_back({"hnsw", nif::make_map(env, {
+    {"n1", nif::make(env, counters.hnsw_n1.load(std::memory_order_relaxed))},
+    {"n2", nif::make(env, counters.hnsw_n2.load(std::memory_order_relaxed))},
+    {"n3", nif::make(env, counters.hnsw_n3.load(std::memory_order_relaxed))},
+    {"ndis", nif::make(env, counters.hnsw_ndis.load(std::memory_order_relaxed))}
+  })});
+
+  return nif::ok(env, nif::make_map(env, pairs));
+}
+
+ERL_NIF_TERM reset_index_stats(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) {
+    return nif::error(env, "Bad argument count.");
+  }
+
+  ex_faiss::ExFaissIndex ** index;
+
+  if (!nif::get<ex_faiss::ExFaissIndex *>(env, argv[0], index)) {
+    return nif::error(env, "Unable to get index.");
+  }
+
+  (*index)->stats().Reset();
+
+  return nif::ok(env);
+}
+
+ERL_NIF_TERM autotune_index(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 7) {
+    return nif::error(env, "Bad argument count.");
+  }
+
+  ex_faiss::ExFaissIndex ** index;
+  int64_t n;
+  ErlNifBinary data;
+  int64_t k;
+  int64_t gt_k;
+  ErlNifBinary gt_labels;
+  int64_t max_experiments;
+
+  if (!nif::get<ex_faiss::ExFaissIndex *>(env, argv[0], index)) {
+    return nif::error(env, "Unable to get index.");
+  }
+  if (!nif::get(env, argv[1], &n)) {
+    return nif::error(env, "Unable to get n.");
+  }
+  if (!nif::get_binary(env, argv[2], &data)) {
+    return nif::error(env, "Unable to get data.");
+  }
+  if (!nif::get(env, argv[3], &k)) {
+    return nif::error(env, "Unable to get k.");
+  }
+  if (!nif::get(env, argv[4], &gt_k)) {
+    return nif::error(env, "Unable to get ground truth k.");
+  }
+  if (!nif::get_binary(env, argv[5], &gt_labels)) {
+    return nif::error(env, "Unable to get ground truth labels.");
+  }
+  if (!nif::get(env, argv[6], &max_experiments)) {
+    return nif::error(env, "Unable to get max experiments.");
+  }
+  if ((*index)->replicated()) {
+    return nif::error(env, "Replicated indices are read-only.");
+  }
+
+  std::vector<ex_faiss::ExFaissOperatingPoint> frontier;
+
+  try {
+    frontier = (*index)->Autotune(n,
+                                  reinterpret_cast<float *>(data.data),
+                                  k,
+                                  gt_k,
+                                  reinterpret_cast<int64_t *>(gt_labels.data),
+                                  max_experiments);
+  } catch (const std::exception& e) {
+    return nif::error(env, e.what());
+  }
+
+  std::vector<ERL_NIF_TERM> points;
+  points.reserve(frontier.size());
+  for (const ex_faiss::ExFaissOperatingPoint& point : frontier) {
+    points.push_back(nif::make_map(env, {
+      {"parameters", nif::make_string(env, point.parameters)},
+      {"recall", nif::make(env, point.recall)},
+      {"seconds", nif::make(env, point.seconds)}
+    }));
+  }
+
+  return nif::ok(env, enif_make_list_from_array(env, points.data(), points.size()));
+}
+
+ERL_NIF_TERM set_index_parameters(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) {
+    return nif::error(env, "Bad argument count.");
+  }
+
+  ex_faiss::ExFaissIndex ** index;
+  std::string parameters;
+
+  if (!nif::get<ex_faiss::ExFaissIndex *>(env, argv[0], index)) {
+    return nif::error(env, "Unable to get index.");
+  }
+  if (!nif::get(env, argv[1], parameters)) {
+    return nif::error(env, "Unable to get parameters.");
+  }
+
+  try {
+    (*index)->SetParameters(parameters.c_str());
+  } catch (const std::exception& e) {
+    return nif::error(env, e.what());
+  }
+
+  return nif::ok(env);
+}
+
+ERL_NIF_TERM set_index_cache(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2) {
+    return nif::error(env, "Bad argument count.");
+  }
+
+  ex_faiss::ExFaissIndex ** index;
+  int64_t capacity;
+
+  if (!nif::get<ex_faiss::ExFaissIndex *>(env, argv[0], index)) {
+    return nif::error(env, "Unable to get index.");
+  }
+  if (!nif::get(env, argv[1], &capacity) || capacity < 0) {
+    return nif::error(env, "Unable to get capacity.");
+  }
+
+  (*index)->SetCache(capacity);
+
+  return nif::ok(env);
+}
+
+ERL_NIF_TERM get_index_cache_stats(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1) {
+    return nif::error(env, "Bad argument count.");
+  }
+
+  ex_faiss::ExFaissIndex ** index;
+
+  if (!nif::get<ex_faiss::ExFaissIndex *>(env, argv[0], index)) {
+    return nif::error(env, "Unable to get index.");
+  }
+
+  ex_faiss::SearchResultCache& cache = (*index)->cache();
+
+  if (!cache.enabled()) {
+    return nif::ok(env, nif::atom(env, "nil"));
+  }
+
+  ERL_NIF_TERM stats = nif::make_map(env, {
+    {"capacity", nif::make(env, static_cast<int64_t>(cache.capacity()))},
+    {"size", nif::make(env, static_cast<int64_t>(cache.size()))},
+    {"hits", nif::make(env, cache.hits())},
+    {"misses", nif::make(env, cache.misses())},
+    {"evictions", nif::make(env, cache.evictions())}
+  });
+
+  return nif::ok(env, stats);
+}
+
 ERL_NIF_TERM index_cpu_to_gpu(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 2) {
     return nif::error(env, "Bad argument count.");
@@ -429,6 +924,10 @@ ERL_NIF_TERM train_clustering(ErlNifEnv * env, int argc, const ERL_NIF_TERM argv
     return nif::error(env, "Unable to get index.");
   }
 
+  if ((*index)->replicated()) {
+    return nif::error(env, "Replicated indices are read-only.");
+  }
+
   (*clustering)->Train(n, reinterpret_cast<float *>(data.data), *index);
 
   return nif::ok(env);
@@ -462,17 +961,27 @@ static ErlNifFunc ex_faiss_funcs[] = {
   // Index CPU
   {"new_index", 3, new_index},
   {"clone_index", 1, clone_index},
+  {"replicate_index", 1, replicate_index, ERL_NIF_DIRTY_JOB_CPU_BOUND},
   {"write_index", 2, write_index, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"read_index", 2, read_index, ERL_NIF_DIRTY_JOB_IO_BOUND},
-  {"add_to_index", 3, add_to_index, ERL_NIF_DIRTY_JOB_CPU_BOUND},
-  {"add_with_ids_to_index", 4, add_with_ids_to_index, ERL_NIF_DIRTY_JOB_CPU_BOUND},
-  {"search_index", 4, search_index, ERL_NIF_DIRTY_JOB_CPU_BOUND},
-  {"train_index", 3, train_index, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+  {"add_to_index", 4, add_to_index, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+  {"add_with_ids_to_index", 5, add_with_ids_to_index, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+  {"search_index", 5, search_index, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+  {"multi_search_index", 6, multi_search_index, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+  {"train_index", 4, train_index, ERL_NIF_DIRTY_JOB_CPU_BOUND},
   {"reset_index", 1, reset_index},
-  {"reconstruct_batch_from_index", 3, reconstruct_batch_from_index},
-  {"compute_residuals_from_index", 4, compute_residuals_from_index},
+  {"reconstruct_batch_from_index", 4, reconstruct_batch_from_index, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+  {"reconstruct_range_from_index", 4, reconstruct_range_from_index, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+  {"compute_residuals_from_index", 4, compute_residuals_from_index, ERL_NIF_DIRTY_JOB_CPU_BOUND},
   {"get_index_dim", 1, get_index_dim},
   {"get_index_n_vectors", 1, get_index_n_vectors},
+  {"get_index_info", 1, get_index_info, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+  {"get_index_stats", 1, get_index_stats},
+  {"reset_index_stats", 1, reset_index_stats},
+  {"autotune_index", 7, autotune_index, ERL_NIF_DIRTY_JOB_CPU_BOUND},
+  {"set_index_parameters", 2, set_index_parameters},
+  {"set_index_cache", 2, set_index_cache},
+  {"get_index_cache_stats", 1, get_index_cache_stats},
   // Index GPU
   {"index_cpu_to_gpu", 2, index_cpu_to_gpu, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"get_num_gpus", 0, get_num_gpus},
@@ -482,4 +991,4 @@ static ErlNifFunc ex_faiss_funcs[] = {
   {"get_clustering_centroids", 1, get_clustering_centroids}
 };
 
-ERL_NIF_INIT(Elixir.ExFaiss.NIF, ex_faiss_funcs, &load, NULL, NULL, NULL);
\ No newline at end of file
+ERL_NIF_INIT(Elixir.ExFaiss.NIF, ex_faiss_funcs, &load, NULL, NULL, &unload);
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <cstring>
+
+#include "cache.h"
+
+namespace ex_faiss {
+
+SearchResultCache::SearchResultCache(size_t capacity)
+    : capacity_(capacity), hits_(0), misses_(0), evictions_(0) {}
+
+// 64-bit FNV-1a over the query bytes, k and generation.
+uint64_t SearchResultCache::Hash(const float * x, int d, int64_t k, uint64_t generation) {
+  uint64_t hash = 14695981039346656037ULL;
+
+  auto mix = [&hash](const void * data, size_t size) {
+    const unsigned char * bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; i++) {
+      hash ^= bytes[i];
+      hash *= 1099511628211ULL;
+    }
+  };
+
+  mix(x, d * sizeof(float));
+  mix(&k, sizeof(k));
+  mix(&generation, sizeof(generation));
+  return hash;
+}
+
+void SearchResultCache::Configure(size_t capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  capacity_.store(capacity, std::memory_order_relaxed);
+  entries_.clear();
+  lookup_.clear();
+  hits_.store(0, std::memory_order_relaxed);
+  misses_.store(0, std::memory_order_relaxed);
+  evictions_.store(0, std::memory_order_relaxed);
+}
+
+bool SearchResultCache::Lookup(const float * x,
+                               int d,
+                               int64_t k,
+                               uint64_t generation,
+                               float * distances,
+                               int64_t * labels) {
+  uint64_t key = Hash(x, d, k, generation);
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto found = lookup_.find(key);
+  if (found == lookup_.end()) {
+    if (capacity_.load(std::memory_order_relaxed) == 0) return false;
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  Entry& entry = *found->second;
+  // Guard against hash collisions
+  if (entry.generation != generation || entry.k != k ||
+      std::memcmp(entry.query.data(), x, d * sizeof(float)) != 0) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  std::copy(entry.distances.begin(), entry.distances.end(), distances);
+  std::copy(entry.labels.begin(), entry.labels.end(), labels);
+  entries_.splice(entries_.begin(), entries_, found->second);
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void SearchResultCache::Insert(const float * x,
+                               int d,
+                               int64_t k,
+                               uint64_t generation,
+                               const float * distances,
+                               const int64_t * labels) {
+  uint64_t key = Hash(x, d, k, generation);
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  size_t capacity = capacity_.load(std::memory_order_relaxed);
+  if (capacity == 0) return;
+
+  auto found = lookup_.find(key);
+  if (found != lookup_.end()) {
+    entries_.erase(found->second);
+    lookup_.erase(found);
+  }
+
+  while (entries_.size() >= capacity) {
+    lookup_.erase(entries_.back().key);
+    entries_.pop_back();
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  entries_.push_front({key,
+                       generation,
+                       k,
+                       std::vector<float>(x, x + d),
+                       std::vector<float>(distances, distances + k),
+                       std::vector<int64_t>(labels, labels + k)});
+  lookup_[key] = entries_.begin();
+}
+
+size_t SearchResultCache::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+} // namespace ex_faiss
@@ -0,0 +1,80 @@
+#ifndef EX_FAISS_CACHE_H_
+#define EX_FAISS_CACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ex_faiss {
+
+// Bounded LRU cache of single-query search results, keyed by the
+// query vector, k and the generation of the index. The index bumps
+// its generation whenever results may change (adding, training,
+// resetting, setting search parameters), so stale entries are
+// never served and age out of the cache.
+//
+// The cache lives as long as its index and is disabled with a
+// capacity of 0. All operations, including changing the capacity,
+// are safe to call concurrently.
+class SearchResultCache {
+ public:
+  explicit SearchResultCache(size_t capacity);
+
+  bool enabled() const { return capacity() > 0; }
+
+  // Drops all entries and statistics, and sets the capacity,
+  // 0 disables the cache.
+  void Configure(size_t capacity);
+
+  // Copies the k cached results of query x into distances and
+  // labels, returns false on a miss.
+  bool Lookup(const float * x,
+              int d,
+              int64_t k,
+              uint64_t generation,
+              float * distances,
+              int64_t * labels);
+
+  void Insert(const float * x,
+              int d,
+              int64_t k,
+              uint64_t generation,
+              const float * distances,
+              const int64_t * labels);
+
+  size_t capacity() const { return capacity_.load(std::memory_order_relaxed); }
+  size_t size();
+
+  int64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+  int64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+  int64_t evictions() const { return evictions_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Entry {
+    uint64_t key;
+    uint64_t generation;
+    int64_t k;
+    std::vector<float> query;
+    std::vector<float> distances;
+    std::vector<int64_t> labels;
+  };
+
+  static uint64_t Hash(const float * x, int d, int64_t k, uint64_t generation);
+
+  // Only written under mutex_, atomic so enabled() can skip locking
+  std::atomic<size_t> capacity_;
+  std::mutex mutex_;
+  // Most recently used first
+  std::list<Entry> entries_;
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> lookup_;
+
+  std::atomic<int64_t> hits_;
+  std::atomic<int64_t> misses_;
+  std::atomic<int64_t> evictions_;
+};
+
+} // namespace ex_faiss
+#endif
@@ -12,7 +12,7 @@ namespace ex_faiss {
   }
 
   void ExFaissClustering::Train(int64_t n, const float * x, ExFaissIndex * index) {
-    clustering_->train(n, x, *(index->index()));
+    index->TrainClustering(clustering_.get(), n, x);
   }
 
 } // namespace ex_faiss
\ No newline at end of file
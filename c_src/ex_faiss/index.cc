@@ -1,6 +1,20 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <limits>
+#include <typeinfo>
+
+#include <faiss/AutoTune.h>
 #include <faiss/index_factory.h>
 #include <faiss/index_io.h>
 #include <faiss/clone_index.h>
+#include <faiss/IndexIVF.h>
+#include <faiss/IndexHNSW.h>
+#include <faiss/IndexPreTransform.h>
+#include <faiss/IndexRefine.h>
+#include <faiss/MetaIndexes.h>
+#include <faiss/impl/io.h>
+#include <faiss/impl/HNSW.h>
 
 #if defined(__CUDA__)
 #include <faiss/gpu/StandardGpuResources.h>
@@ -8,9 +22,55 @@
 #endif
 
 #include "index.h"
+#include "numa.h"
+#include "thread_pool.h"
 
 namespace ex_faiss {
 
+namespace {
+
+// Looks through the wrapper indices produced by the index factory
+// (pre-transforms, ID maps, refinement) for an index of type T.
+template <typename T>
+T * ExtractIndex(faiss::Index * index) {
+  while (index != nullptr) {
+    if (T * found = dynamic_cast<T *>(index)) {
+      return found;
+    } else if (auto * pt = dynamic_cast<faiss::IndexPreTransform *>(index)) {
+      index = pt->index;
+    } else if (auto * idmap = dynamic_cast<faiss::IndexIDMap *>(index)) {
+      index = idmap->index;
+    } else if (auto * refine = dynamic_cast<faiss::IndexRefine *>(index)) {
+      index = refine->base_index;
+    } else {
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+// Writer which only counts the bytes it is given, used to
+// size an index without materializing its serialization.
+struct CountingIOWriter : faiss::IOWriter {
+  size_t bytes = 0;
+
+  size_t operator()(const void * ptr, size_t size, size_t nitems) override {
+    bytes += size * nitems;
+    return nitems;
+  }
+};
+
+std::string DemangledClassName(const faiss::Index * index) {
+  const char * mangled = typeid(*index).name();
+  int status = 0;
+  char * demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+  std::string name = status == 0 ? demangled : mangled;
+  std::free(demangled);
+  return name;
+}
+
+} // namespace
+
 ExFaissIndex::ExFaissIndex(faiss::Index * index) {
   index_ = std::unique_ptr<faiss::Index>(index);
 }
@@ -37,34 +97,262 @@ ExFaissIndex * ExFaissIndex::CloneToGpu(int device) {
   #endif
 }
 
+ExFaissIndex * ExFaissIndex::CloneReplicated() {
+  const NumaTopology& topology = NumaTopology::Get();
+  std::vector<std::unique_ptr<faiss::Index>> copies(topology.num_nodes());
+
+  for (int node = 0; node < topology.num_nodes(); node++) {
+    RunOnNode(node, [&]() {
+      copies[node].reset(faiss::clone_index(index_.get()));
+    });
+  }
+
+  ExFaissIndex * replicated = new ExFaissIndex(copies[0].release());
+  for (int node = 1; node < topology.num_nodes(); node++) {
+    replicated->replicas_.push_back(std::move(copies[node]));
+  }
+  replicated->replicated_ = true;
+  return replicated;
+}
+
+faiss::Index * ExFaissIndex::LocalIndex() {
+  if (replicas_.empty()) return index_.get();
+  int node = NumaTopology::Get().CurrentNode();
+  return node == 0 ? index_.get() : replicas_[node - 1].get();
+}
+
 void ExFaissIndex::Add(int64_t n, const float * x) {
+  ScopedOperationTimer timer(stats_.op(kAdd), n);
   index_->add(n, x);
+  BumpGeneration();
 }
 
 void ExFaissIndex::AddWithIds(int64_t n, const float * x, const int64_t * xids) {
+  ScopedOperationTimer timer(stats_.op(kAdd), n);
   index_->add_with_ids(n, x, xids);
+  BumpGeneration();
+}
+
+void ExFaissIndex::Search(int64_t n,
+                          const float * x,
+                          int64_t k,
+                          float * distances,
+                          int64_t * labels,
+                          bool count_faiss_stats) {
+  ScopedOperationTimer timer(stats_.op(kSearch), n);
+
+  if (!cache_.enabled()) {
+    SearchIndex(n, x, k, distances, labels, count_faiss_stats);
+    return;
+  }
+
+  // Read the generation before searching, so results raced by a
+  // mutation are inserted as already stale
+  uint64_t generation = generation_.load(std::memory_order_acquire);
+  int d = dim();
+  std::vector<int64_t> misses;
+
+  for (int64_t i = 0; i < n; i++) {
+    if (!cache_.Lookup(x + i * d, d, k, generation, distances + i * k, labels + i * k)) {
+      misses.push_back(i);
+    }
+  }
+
+  if (misses.empty()) return;
+
+  int64_t n_misses = misses.size();
+  std::vector<float> miss_x(n_misses * d);
+  std::vector<float> miss_distances(n_misses * k);
+  std::vector<int64_t> miss_labels(n_misses * k);
+
+  for (int64_t j = 0; j < n_misses; j++) {
+    std::copy(x + misses[j] * d, x + (misses[j] + 1) * d, miss_x.begin() + j * d);
+  }
+
+  SearchIndex(n_misses, miss_x.data(), k, miss_distances.data(), miss_labels.data(), count_faiss_stats);
+
+  for (int64_t j = 0; j < n_misses; j++) {
+    int64_t i = misses[j];
+    std::copy(miss_distances.begin() + j * k, miss_distances.begin() + (j + 1) * k, distances + i * k);
+    std::copy(miss_labels.begin() + j * k, miss_labels.begin() + (j + 1) * k, labels + i * k);
+    cache_.Insert(x + i * d, d, k, generation, distances + i * k, labels + i * k);
+  }
 }
 
-void ExFaissIndex::Search(int64_t n, const float * x, int64_t k, float * distances, int64_t * labels) {
-  index_->search(n, x, k, distances, labels);
+void ExFaissIndex::SearchIndex(int64_t n,
+                               const float * x,
+                               int64_t k,
+                               float * distances,
+                               int64_t * labels,
+                               bool count_faiss_stats) {
+  if (!count_faiss_stats) {
+    LocalIndex()->search(n, x, k, distances, labels);
+    return;
+  }
+
+  faiss::IndexIVFStats ivf_before = faiss::indexIVF_stats;
+  faiss::HNSWStats hnsw_before = faiss::hnsw_stats;
+
+  LocalIndex()->search(n, x, k, distances, labels);
+
+  const faiss::IndexIVFStats& ivf_after = faiss::indexIVF_stats;
+  const faiss::HNSWStats& hnsw_after = faiss::hnsw_stats;
+  FaissSearchCounters& counters = stats_.faiss_counters();
+  counters.ivf_nq.fetch_add(ivf_after.nq - ivf_before.nq, std::memory_order_relaxed);
+  counters.ivf_nlist.fetch_add(ivf_after.nlist - ivf_before.nlist, std::memory_order_relaxed);
+  counters.ivf_ndis.fetch_add(ivf_after.ndis - ivf_before.ndis, std::memory_order_relaxed);
+  counters.ivf_nheap_updates.fetch_add(ivf_after.nheap_updates - ivf_before.nheap_updates,
+                                       std::memory_order_relaxed);
+  counters.hnsw_n1.fetch_add(hnsw_after.n1 - hnsw_before.n1, std::memory_order_relaxed);
+  counters.hnsw_n2.fetch_add(hnsw_after.n2 - hnsw_before.n2, std::memory_order_relaxed);
+  counters.hnsw_n3.fetch_add(hnsw_after.n3 - hnsw_before.n3, std::memory_order_relaxed);
+  counters.hnsw_ndis.fetch_add(hnsw_after.ndis - hnsw_before.ndis, std::memory_order_relaxed);
 }
 
 void ExFaissIndex::Train(int64_t n, const float * x) {
+  ScopedOperationTimer timer(stats_.op(kTrain), n);
   index_->train(n, x);
+  BumpGeneration();
 }
 
 void ExFaissIndex::Reset() {
   index_->reset();
+  BumpGeneration();
 }
 
 void ExFaissIndex::ReconstructBatch(int64_t n, const int64_t * keys, float * recons) {
+  ScopedOperationTimer timer(stats_.op(kReconstruct), n);
   index_->reconstruct_batch(n, keys, recons);
 }
 
+void ExFaissIndex::ReconstructRange(int64_t i0, int64_t ni, float * recons) {
+  ScopedOperationTimer timer(stats_.op(kReconstruct), ni);
+  index_->reconstruct_n(i0, ni, recons);
+}
+
 void ExFaissIndex::ComputeResiduals(int64_t n, const float * data, float * resid, const int64_t * keys) {
   index_->compute_residual_n(n, data, resid, keys);
 }
 
+ExFaissIndexInfo ExFaissIndex::Info() {
+  faiss::Index * index = index_.get();
+  ExFaissIndexInfo info = {};
+
+  info.class_name = DemangledClassName(index);
+  info.is_trained = index->is_trained;
+  info.metric_type = index->metric_type;
+
+  try {
+    info.sa_code_size = index->sa_code_size();
+  } catch (const std::exception& e) {
+    info.sa_code_size = -1;
+  }
+
+  try {
+    CountingIOWriter writer;
+    faiss::write_index(index, &writer);
+    // Every replica holds a full copy of the index
+    info.total_bytes = writer.bytes * num_replicas();
+  } catch (const std::exception& e) {
+    info.total_bytes = -1;
+  }
+
+  if (faiss::IndexIVF * ivf = ExtractIndex<faiss::IndexIVF>(index)) {
+    std::vector<int64_t> sizes(ivf->nlist);
+    for (size_t i = 0; i < ivf->nlist; i++) {
+      sizes[i] = ivf->invlists->list_size(i);
+    }
+    std::sort(sizes.begin(), sizes.end());
+
+    auto percentile = [&sizes](double p) -> int64_t {
+      if (sizes.empty()) return 0;
+      size_t rank = static_cast<size_t>(p * (sizes.size() - 1) + 0.5);
+      return sizes[rank];
+    };
+
+    info.is_ivf = true;
+    info.ivf.nlist = ivf->nlist;
+    info.ivf.nprobe = ivf->nprobe;
+    info.ivf.list_size_min = sizes.empty() ? 0 : sizes.front();
+    info.ivf.list_size_max = sizes.empty() ? 0 : sizes.back();
+    info.ivf.list_size_p50 = percentile(0.50);
+    info.ivf.list_size_p90 = percentile(0.90);
+    info.ivf.list_size_p99 = percentile(0.99);
+    // Faiss divides by the squared total, which is NaN on empty lists
+    info.ivf.imbalance_factor = ivf->ntotal == 0 ? 0.0 : ivf->invlists->imbalance_factor();
+  }
+
+  if (faiss::IndexHNSW * hnsw = ExtractIndex<faiss::IndexHNSW>(index)) {
+    const faiss::HNSW& graph = hnsw->hnsw;
+
+    info.is_hnsw = true;
+    info.hnsw.max_level = graph.max_level;
+    info.hnsw.entry_point = graph.entry_point;
+    info.hnsw.ef_search = graph.efSearch;
+    info.hnsw.ef_construction = graph.efConstruction;
+    // HNSW stores each node's level + 1
+    info.hnsw.levels.assign(std::max(graph.max_level + 1, 0), 0);
+    for (int level : graph.levels) {
+      for (int l = 0; l < level && l <= graph.max_level; l++) {
+        info.hnsw.levels[l]++;
+      }
+    }
+  }
+
+  return info;
+}
+
+std::vector<ExFaissOperatingPoint> ExFaissIndex::Autotune(int64_t nq,
+                                                          const float * x,
+                                                          int64_t k,
+                                                          int64_t gt_k,
+                                                          const int64_t * gt_labels,
+                                                          int64_t max_experiments) {
+  faiss::ParameterSpace space;
+  space.verbose = 0;
+  space.n_experiments = max_experiments;
+  space.initialize(index_.get());
+
+  faiss::IntersectionCriterion criterion(nq, k);
+  criterion.set_groundtruth(gt_k, nullptr, gt_labels);
+
+  faiss::OperatingPoints points;
+  // Exploration leaves the index at its last tried parameters,
+  // even when it fails part way
+  try {
+    space.explore(index_.get(), nq, x, criterion, &points);
+  } catch (...) {
+    BumpGeneration();
+    throw;
+  }
+  BumpGeneration();
+
+  std::vector<ExFaissOperatingPoint> frontier;
+  frontier.reserve(points.optimal_pts.size());
+  for (const faiss::OperatingPoint& point : points.optimal_pts) {
+    frontier.push_back({point.key, point.perf, point.t});
+  }
+  return frontier;
+}
+
+void ExFaissIndex::SetParameters(const char * parameters) {
+  faiss::ParameterSpace space;
+  space.set_index_parameters(index_.get(), parameters);
+  for (auto& replica : replicas_) {
+    space.set_index_parameters(replica.get(), parameters);
+  }
+  BumpGeneration();
+}
+
+void ExFaissIndex::SetCache(size_t capacity) {
+  cache_.Configure(capacity);
+}
+
+void ExFaissIndex::TrainClustering(faiss::Clustering * clustering, int64_t n, const float * x) {
+  clustering->train(n, x, *index_);
+  BumpGeneration();
+}
+
 void ExFaissIndex::WriteToFile(const char * fname) {
   faiss::write_index(index_.get(), fname);
 }
@@ -73,4 +361,78 @@ ExFaissIndex * ReadIndexFromFile(const char * fname, int io_flags) {
   faiss::Index * index = faiss::read_index(fname, io_flags);
   return new ExFaissIndex(index);
 }
-} // namespace ex_faiss
\ No newline at end of file
+
+void MultiSearch(const std::vector<ExFaissIndex *>& indices,
+                 int64_t n,
+                 const float * x,
+                 int64_t k,
+                 float * distances,
+                 int64_t * labels) {
+  auto search = [&](int64_t i) {
+    // Every index is searched concurrently, so before/after deltas
+    // of Faiss' process-wide counters would include the others' work
+    indices[i]->Search(n, x, k, distances + i * n * k, labels + i * n * k, false);
+  };
+
+#if defined(_OPENMP)
+  ThreadPool::Get().ParallelFor(indices.size(), search);
+#else
+  // Pool workers can't be limited to one Faiss thread each, so
+  // searching in parallel would oversubscribe every core
+  for (size_t i = 0; i < indices.size(); i++) {
+    search(i);
+  }
+#endif
+}
+
+void MergeSearchResults(int64_t num_indices,
+                        int64_t n,
+                        int64_t k,
+                        faiss::MetricType metric_type,
+                        const float * distances,
+                        const int64_t * labels,
+                        float * merged_distances,
+                        int64_t * merged_labels,
+                        int32_t * tenants) {
+  // Inner product is a similarity, every other metric a distance
+  bool descending = metric_type == faiss::METRIC_INNER_PRODUCT;
+  float missing = descending ? -std::numeric_limits<float>::infinity()
+                             : std::numeric_limits<float>::infinity();
+
+  struct Candidate {
+    float distance;
+    int64_t label;
+    int32_t tenant;
+  };
+
+  std::vector<Candidate> candidates;
+  candidates.reserve(num_indices * k);
+
+  for (int64_t q = 0; q < n; q++) {
+    candidates.clear();
+    for (int64_t i = 0; i < num_indices; i++) {
+      const float * d = distances + (i * n + q) * k;
+      const int64_t * l = labels + (i * n + q) * k;
+      for (int64_t j = 0; j < k; j++) {
+        if (l[j] >= 0) {
+          candidates.push_back({d[j], l[j], static_cast<int32_t>(i)});
+        }
+      }
+    }
+
+    int64_t found = std::min<int64_t>(k, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + found, candidates.end(),
+                      [descending](const Candidate& a, const Candidate& b) {
+                        return descending ? a.distance > b.distance : a.distance < b.distance;
+                      });
+
+    for (int64_t j = 0; j < k; j++) {
+      bool valid = j < found;
+      merged_distances[q * k + j] = valid ? candidates[j].distance : missing;
+      merged_labels[q * k + j] = valid ? candidates[j].label : -1;
+      tenants[q * k + j] = valid ? candidates[j].tenant : -1;
+    }
+  }
+}
+
+} // namespace ex_faiss
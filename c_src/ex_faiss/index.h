@@ -1,12 +1,65 @@
 #ifndef EX_FAISS_INDEX_H_
 #define EX_FAISS_INDEX_H_
 
+#include <atomic>
 #include <memory>
 #include <cstdint>
+#include <string>
+#include <vector>
 #include <faiss/Index.h>
+#include <faiss/Clustering.h>
+
+#include "cache.h"
+#include "stats.h"
 
 namespace ex_faiss {
 
+// Inverted list statistics, only populated for IVF indices.
+struct ExFaissIVFInfo {
+  int64_t nlist;
+  int64_t nprobe;
+  int64_t list_size_min;
+  int64_t list_size_max;
+  int64_t list_size_p50;
+  int64_t list_size_p90;
+  int64_t list_size_p99;
+  double imbalance_factor;
+};
+
+// Graph statistics, only populated for HNSW indices. levels[l]
+// is the number of nodes present at level l.
+struct ExFaissHNSWInfo {
+  int max_level;
+  int64_t entry_point;
+  int ef_search;
+  int ef_construction;
+  std::vector<int64_t> levels;
+};
+
+struct ExFaissIndexInfo {
+  std::string class_name;
+  bool is_trained;
+  faiss::MetricType metric_type;
+  // -1 when the index does not implement the standalone codec
+  int64_t sa_code_size;
+  // Serialized size of the index times the number of replicas,
+  // -1 when it cannot be serialized
+  int64_t total_bytes;
+  bool is_ivf;
+  ExFaissIVFInfo ivf;
+  bool is_hnsw;
+  ExFaissHNSWInfo hnsw;
+};
+
+// A point on the recall/latency Pareto frontier explored by
+// Autotune. parameters is a Faiss ParameterSpace string which
+// can be passed to SetParameters.
+struct ExFaissOperatingPoint {
+  std::string parameters;
+  double recall;
+  double seconds;
+};
+
 class ExFaissIndex {
  public:
   ExFaissIndex(faiss::Index * index);
@@ -17,11 +70,14 @@ class ExFaissIndex {
 
   void AddWithIds(int64_t n, const float * x, const int64_t * xids);
 
+  // When count_faiss_stats is false, the deltas of Faiss' process-wide
+  // search counters are not attributed to this index.
   void Search(int64_t n,
               const float * x,
               int64_t k,
               float * distances,
-              int64_t * labels);
+              int64_t * labels,
+              bool count_faiss_stats = true);
 
   void Train(int64_t n, const float * x);
 
@@ -31,21 +87,107 @@ class ExFaissIndex {
 
   ExFaissIndex * CloneToGpu(int device);
 
+  // Creates a read-only copy of the index with one replica per NUMA
+  // node, each allocated from a thread pinned to that node. Searches
+  // are routed to the replica local to the calling thread.
+  ExFaissIndex * CloneReplicated();
+
   void Reset();
 
   void ReconstructBatch(int64_t n, const int64_t * keys, float * recons);
 
+  // Reconstructs the contiguous range [i0, i0 + ni) of stored vectors.
+  // Flat and scalar quantizer indices decode the range in one pass.
+  void ReconstructRange(int64_t i0, int64_t ni, float * recons);
+
   void ComputeResiduals(int64_t n, const float * data, float * resid, const int64_t * keys);
 
+  ExFaissIndexInfo Info();
+
+  // Explores the index search parameters on the given queries and
+  // returns the Pareto-optimal operating points, ordered by recall.
+  // recall is the k-recall@k against the gt_k ground truth labels.
+  std::vector<ExFaissOperatingPoint> Autotune(int64_t nq,
+                                              const float * x,
+                                              int64_t k,
+                                              int64_t gt_k,
+                                              const int64_t * gt_labels,
+                                              int64_t max_experiments);
+
+  void SetParameters(const char * parameters);
+
+  // Enables an LRU cache of up to capacity single-query search
+  // results, or disables it when capacity is 0. Safe to call
+  // concurrently with searches.
+  void SetCache(size_t capacity);
+
+  SearchResultCache& cache() { return cache_; }
+
+  // Trains the clustering, which resets and fills this index with
+  // the centroids, invalidating cached search results.
+  void TrainClustering(faiss::Clustering * clustering, int64_t n, const float * x);
+
+  ExFaissIndexStats& stats() { return stats_; }
+
+  bool replicated() { return replicated_; }
+  int num_replicas() { return replicas_.size() + 1; }
+
   faiss::Index * index() { return index_.get(); }
   int dim() { return index_->d; }
   int64_t n_total() { return index_->ntotal; }
 
  private:
+  // Replica to search from the calling thread
+  faiss::Index * LocalIndex();
+
+  // Searches the underlying index, bypassing the result cache
+  void SearchIndex(int64_t n,
+                   const float * x,
+                   int64_t k,
+                   float * distances,
+                   int64_t * labels,
+                   bool count_faiss_stats);
+
+  // Invalidates cached search results
+  void BumpGeneration() { generation_.fetch_add(1, std::memory_order_release); }
+
   std::unique_ptr<faiss::Index> index_;
+  // Replicas for NUMA nodes 1..n, index_ serves node 0
+  std::vector<std::unique_ptr<faiss::Index>> replicas_;
+  bool replicated_ = false;
+  ExFaissIndexStats stats_;
+  SearchResultCache cache_{0};
+  std::atomic<uint64_t> generation_{0};
 };
 
 ExFaissIndex * ReadIndexFromFile(const char * fname, int io_flags);
 
+// Searches the same n queries against every index in parallel on the
+// shared ThreadPool, each search using a single Faiss thread. Without
+// OpenMP the indices are searched in turn on the calling thread. Results
+// are laid out index-major, i.e. the results of indices[i] start at
+// distances + i * n * k. Faiss' IVF/HNSW counters are not attributed
+// to the indices, as concurrent searches make per-index deltas
+// meaningless.
+void MultiSearch(const std::vector<ExFaissIndex *>& indices,
+                 int64_t n,
+                 const float * x,
+                 int64_t k,
+                 float * distances,
+                 int64_t * labels);
+
+// Merges index-major MultiSearch results into a global top-k per
+// query. tenants holds the position of the index each result came
+// from, or -1 where fewer than k results were found.
+void MergeSearchResults(int64_t num_indices,
+                        int64_t n,
+                        int64_t k,
+                        faiss::MetricType metric_type,
+                        const float * distances,
+                        const int64_t * labels,
+                        float * merged_distances,
+                        int64_t * merged_labels,
+                        int32_t * tenants);
+
 } // namespace ex_faiss
 #endif
\ No newline at end of file
@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include "nif_util.h"
 
 namespace nif {
@@ -28,6 +30,48 @@ namespace nif {
     return enif_make_binary(env, &var);
   }
 
+  ERL_NIF_TERM make(ErlNifEnv * env, double var) {
+    return enif_make_double(env, var);
+  }
+
+  ERL_NIF_TERM make(ErlNifEnv * env, bool var) {
+    return atom(env, var ? "true" : "false");
+  }
+
+  ERL_NIF_TERM atom(ErlNifEnv * env, const char * name) {
+    return enif_make_atom(env, name);
+  }
+
+  ERL_NIF_TERM make_string(ErlNifEnv * env, const std::string& var) {
+    ERL_NIF_TERM term;
+    unsigned char * data = enif_make_new_binary(env, var.size(), &term);
+    std::memcpy(data, var.data(), var.size());
+    return term;
+  }
+
+  ERL_NIF_TERM make_list(ErlNifEnv * env, const std::vector<int64_t>& var) {
+    std::vector<ERL_NIF_TERM> terms;
+    terms.reserve(var.size());
+    for (int64_t elem : var) {
+      terms.push_back(enif_make_int64(env, elem));
+    }
+    return enif_make_list_from_array(env, terms.data(), terms.size());
+  }
+
+  ERL_NIF_TERM make_map(ErlNifEnv * env,
+                        const std::vector<std::pair<const char *, ERL_NIF_TERM>>& pairs) {
+    std::vector<ERL_NIF_TERM> keys, values;
+    keys.reserve(pairs.size());
+    values.reserve(pairs.size());
+    for (const auto& pair : pairs) {
+      keys.push_back(atom(env, pair.first));
+      values.push_back(pair.second);
+    }
+    ERL_NIF_TERM map;
+    enif_make_map_from_arrays(env, keys.data(), values.data(), keys.size(), &map);
+    return map;
+  }
+
   int get(ErlNifEnv* env, ERL_NIF_TERM term, int32_t * var) {
     return enif_get_int(env, term,
                         reinterpret_cast<int32_t *>(var));
@@ -64,6 +108,11 @@ namespace nif {
     return ret;
   }
 
+  int64_t nanoseconds_since(ErlNifTime start) {
+    ErlNifTime elapsed = enif_monotonic_time(ERL_NIF_NATIVE) - start;
+    return enif_convert_time_unit(elapsed, ERL_NIF_NATIVE, ERL_NIF_NSEC);
+  }
+
   int get_metric_type(ErlNifEnv * env, ERL_NIF_TERM term, faiss::MetricType * metric_type) {
     int value;
     if (!enif_get_int(env, term, &value)) return 0;
@@ -1,6 +1,8 @@
 #ifndef EX_FAISS_NIF_UTIL_H_
 #define EX_FAISS_NIF_UTIL_H_
 
+#include <string>
+#include <utility>
 #include <vector>
 #include <erl_nif.h>
 #include <faiss/Index.h>
@@ -23,11 +25,25 @@ ERL_NIF_TERM error(ErlNifEnv * env, const char * msg);
 ERL_NIF_TERM make(ErlNifEnv * env, int var);
 ERL_NIF_TERM make(ErlNifEnv * env, int64_t var);
 ERL_NIF_TERM make(ErlNifEnv * env, ErlNifBinary var);
+ERL_NIF_TERM make(ErlNifEnv * env, double var);
+ERL_NIF_TERM make(ErlNifEnv * env, bool var);
+
+ERL_NIF_TERM atom(ErlNifEnv * env, const char * name);
+ERL_NIF_TERM make_string(ErlNifEnv * env, const std::string& var);
+ERL_NIF_TERM make_list(ErlNifEnv * env, const std::vector<int64_t>& var);
+
+// Builds a map with atom keys from the given key/value pairs.
+ERL_NIF_TERM make_map(ErlNifEnv * env,
+                      const std::vector<std::pair<const char *, ERL_NIF_TERM>>& pairs);
 
 int get(ErlNifEnv * env, ERL_NIF_TERM term, int32_t * var);
 int get(ErlNifEnv * env, ERL_NIF_TERM term, int64_t * var);
 int get(ErlNifEnv * env, ERL_NIF_TERM term, std::string& var);
 
+// Nanoseconds elapsed since the given native monotonic time, as
+// returned by :erlang.monotonic_time/0 on the caller side.
+int64_t nanoseconds_since(ErlNifTime start);
+
 int get_metric_type(ErlNifEnv * env, ERL_NIF_TERM ter, faiss::MetricType * metric_type);
 
 int get_binary(ErlNifEnv * env, ERL_NIF_TERM term, ErlNifBinary * var);
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "numa.h"
+
+namespace ex_faiss {
+
+namespace {
+
+// Parses a sysfs CPU list such as "0-3,8-11".
+std::vector<int> ParseCpuList(const std::string& list) {
+  std::vector<int> cpus;
+  std::stringstream stream(list);
+  std::string range;
+
+  while (std::getline(stream, range, ',')) {
+    size_t dash = range.find('-');
+    try {
+      int first = std::stoi(range.substr(0, dash));
+      int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      for (int cpu = first; cpu <= last; cpu++) {
+        cpus.push_back(cpu);
+      }
+    } catch (const std::exception& e) {
+      // Skip malformed or empty entries
+    }
+  }
+
+  return cpus;
+}
+
+} // namespace
+
+const NumaTopology& NumaTopology::Get() {
+  static const NumaTopology topology;
+  return topology;
+}
+
+NumaTopology::NumaTopology() {
+#if defined(__linux__)
+  std::vector<int> os_nodes;
+
+  if (DIR * dir = opendir("/sys/devices/system/node")) {
+    while (struct dirent * entry = readdir(dir)) {
+      int os_node;
+      if (std::sscanf(entry->d_name, "node%d", &os_node) == 1) {
+        os_nodes.push_back(os_node);
+      }
+    }
+    closedir(dir);
+  }
+
+  std::sort(os_nodes.begin(), os_nodes.end());
+
+  for (int os_node : os_nodes) {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(os_node) + "/cpulist");
+    std::string list;
+    std::getline(file, list);
+    std::vector<int> cpus = ParseCpuList(list);
+    // Memory-only nodes have no CPUs to route searches from
+    if (!cpus.empty()) {
+      node_cpus_.push_back(cpus);
+    }
+  }
+#endif
+
+  if (node_cpus_.empty()) {
+    node_cpus_.push_back({});
+    return;
+  }
+
+  for (size_t node = 0; node < node_cpus_.size(); node++) {
+    for (int cpu : node_cpus_[node]) {
+      if (cpu >= static_cast<int>(cpu_node_.size())) {
+        cpu_node_.resize(cpu + 1, 0);
+      }
+      cpu_node_[cpu] = node;
+    }
+  }
+}
+
+int NumaTopology::CurrentNode() const {
+#if defined(__linux__)
+  int cpu = sched_getcpu();
+  if (cpu >= 0 && cpu < static_cast<int>(cpu_node_.size())) {
+    return cpu_node_[cpu];
+  }
+#endif
+  return 0;
+}
+
+void RunOnNode(int node, const std::function<void()>& fn) {
+#if defined(__linux__)
+  const std::vector<int>& cpus = NumaTopology::Get().cpus(node);
+  std::exception_ptr error;
+
+  std::thread thread([&]() {
+    if (!cpus.empty()) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+      }
+      pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    try {
+      fn();
+    } catch (...) {
+      error = std::current_exception();
+    }
+  });
+  thread.join();
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+#else
+  fn();
+#endif
+}
+
+} // namespace ex_faiss
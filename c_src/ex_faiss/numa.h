@@ -0,0 +1,35 @@
+#ifndef EX_FAISS_NUMA_H_
+#define EX_FAISS_NUMA_H_
+
+#include <functional>
+#include <vector>
+
+namespace ex_faiss {
+
+// NUMA topology of the host, discovered once from sysfs. Nodes
+// are numbered densely from 0, regardless of the OS node ids. On
+// platforms without NUMA information there is a single node.
+class NumaTopology {
+ public:
+  static const NumaTopology& Get();
+
+  int num_nodes() const { return node_cpus_.size(); }
+  const std::vector<int>& cpus(int node) const { return node_cpus_[node]; }
+
+  // Node of the CPU the calling thread is currently running on.
+  int CurrentNode() const;
+
+ private:
+  NumaTopology();
+
+  std::vector<std::vector<int>> node_cpus_;
+  std::vector<int> cpu_node_;
+};
+
+// Runs fn to completion on a thread pinned to the CPUs of the given
+// node, so memory it first touches is allocated on that node.
+// Exceptions thrown by fn are rethrown on the calling thread.
+void RunOnNode(int node, const std::function<void()>& fn);
+
+} // namespace ex_faiss
+#endif
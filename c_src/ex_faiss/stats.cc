@@ -0,0 +1,75 @@
+#include "stats.h"
+
+namespace ex_faiss {
+
+const char * OperationName(Operation op) {
+  switch (op) {
+    case kAdd: return "add";
+    case kSearch: return "search";
+    case kTrain: return "train";
+    case kReconstruct: return "reconstruct";
+    default: return "unknown";
+  }
+}
+
+void LatencyHistogram::Record(int64_t ns) {
+  int bucket = 0;
+  if (ns > 0) {
+    bucket = 63 - __builtin_clzll(static_cast<uint64_t>(ns));
+    if (bucket >= kNumBuckets) bucket = kNumBuckets - 1;
+  } else {
+    ns = 0;
+  }
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  total_ns_.fetch_add(ns, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Reset() {
+  for (int i = 0; i < kNumBuckets; i++) {
+    buckets_[i].store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  total_ns_.store(0, std::memory_order_relaxed);
+}
+
+std::vector<int64_t> LatencyHistogram::buckets() const {
+  std::vector<int64_t> result(kNumBuckets);
+  for (int i = 0; i < kNumBuckets; i++) {
+    result[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
+void OperationStats::Reset() {
+  items.store(0, std::memory_order_relaxed);
+  exec.Reset();
+  wait.Reset();
+}
+
+void FaissSearchCounters::Reset() {
+  ivf_nq.store(0, std::memory_order_relaxed);
+  ivf_nlist.store(0, std::memory_order_relaxed);
+  ivf_ndis.store(0, std::memory_order_relaxed);
+  ivf_nheap_updates.store(0, std::memory_order_relaxed);
+  hnsw_n1.store(0, std::memory_order_relaxed);
+  hnsw_n2.store(0, std::memory_order_relaxed);
+  hnsw_n3.store(0, std::memory_order_relaxed);
+  hnsw_ndis.store(0, std::memory_order_relaxed);
+}
+
+void ExFaissIndexStats::Reset() {
+  for (int i = 0; i < kNumOperations; i++) {
+    ops_[i].Reset();
+  }
+  faiss_counters_.Reset();
+}
+
+ScopedOperationTimer::~ScopedOperationTimer() {
+  auto elapsed = std::chrono::steady_clock::now() - start_;
+  int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  stats_.exec.Record(ns);
+  stats_.items.fetch_add(n_, std::memory_order_relaxed);
+}
+
+} // namespace ex_faiss
@@ -0,0 +1,104 @@
+#ifndef EX_FAISS_STATS_H_
+#define EX_FAISS_STATS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace ex_faiss {
+
+// Instrumented index operations.
+enum Operation {
+  kAdd = 0,
+  kSearch,
+  kTrain,
+  kReconstruct,
+  kNumOperations
+};
+
+const char * OperationName(Operation op);
+
+// Lock-free latency histogram with log2 buckets. Bucket i
+// counts samples in [2^i, 2^(i+1)) nanoseconds, the last
+// bucket also counts everything above it.
+class LatencyHistogram {
+ public:
+  static const int kNumBuckets = 40;
+
+  LatencyHistogram() { Reset(); }
+
+  void Record(int64_t ns);
+  void Reset();
+
+  int64_t count() const { return count_.load(std::memory_order_relaxed); }
+  int64_t total_ns() const { return total_ns_.load(std::memory_order_relaxed); }
+  std::vector<int64_t> buckets() const;
+
+ private:
+  std::atomic<int64_t> buckets_[kNumBuckets];
+  std::atomic<int64_t> count_;
+  std::atomic<int64_t> total_ns_;
+};
+
+struct OperationStats {
+  OperationStats() { Reset(); }
+
+  void Reset();
+
+  // Number of vectors processed across all calls
+  std::atomic<int64_t> items;
+  // Time spent inside Faiss
+  LatencyHistogram exec;
+  // Time between the caller issuing the NIF call and the
+  // NIF starting to execute, i.e. scheduler queueing
+  LatencyHistogram wait;
+};
+
+// Faiss keeps its search counters in process-wide globals, these
+// accumulate the deltas observed around searches on one index. With
+// concurrent searches on other indices the attribution is approximate.
+struct FaissSearchCounters {
+  FaissSearchCounters() { Reset(); }
+
+  void Reset();
+
+  std::atomic<int64_t> ivf_nq;
+  std::atomic<int64_t> ivf_nlist;
+  std::atomic<int64_t> ivf_ndis;
+  std::atomic<int64_t> ivf_nheap_updates;
+  std::atomic<int64_t> hnsw_n1;
+  std::atomic<int64_t> hnsw_n2;
+  std::atomic<int64_t> hnsw_n3;
+  std::atomic<int64_t> hnsw_ndis;
+};
+
+class ExFaissIndexStats {
+ public:
+  OperationStats& op(Operation op) { return ops_[op]; }
+  FaissSearchCounters& faiss_counters() { return faiss_counters_; }
+
+  void Reset();
+
+ private:
+  OperationStats ops_[kNumOperations];
+  FaissSearchCounters faiss_counters_;
+};
+
+// Records the execution time and item count of an operation
+// into the given stats when it goes out of scope.
+class ScopedOperationTimer {
+ public:
+  ScopedOperationTimer(OperationStats& stats, int64_t n)
+      : stats_(stats), n_(n), start_(std::chrono::steady_clock::now()) {}
+
+  ~ScopedOperationTimer();
+
+ private:
+  OperationStats& stats_;
+  int64_t n_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace ex_faiss
+#endif
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <exception>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "thread_pool.h"
+
+namespace ex_faiss {
+
+namespace {
+
+std::mutex pool_mutex;
+ThreadPool * pool = nullptr;
+
+} // namespace
+
+ThreadPool& ThreadPool::Get() {
+  std::lock_guard<std::mutex> lock(pool_mutex);
+  if (pool == nullptr) {
+    pool = new ThreadPool(std::max(1u, std::thread::hardware_concurrency()));
+  }
+  return *pool;
+}
+
+void ThreadPool::Shutdown() {
+  std::lock_guard<std::mutex> lock(pool_mutex);
+  delete pool;
+  pool = nullptr;
+}
+
+ThreadPool::ThreadPool(int num_threads) {
+  for (int i = 0; i < num_threads; i++) {
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::WorkerLoop() {
+#if defined(_OPENMP)
+  // Only affects this worker thread
+  omp_set_num_threads(1);
+#endif
+
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+      if (tasks_.empty()) return;
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+void ThreadPool::ParallelFor(int64_t n, const std::function<void(int64_t)>& fn) {
+  if (n <= 0) return;
+
+  std::mutex done_mutex;
+  std::condition_variable done_cv;
+  int64_t remaining = n;
+  std::exception_ptr error;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int64_t i = 0; i < n; i++) {
+      tasks_.push_back([&, i]() {
+        std::exception_ptr task_error;
+        try {
+          fn(i);
+        } catch (...) {
+          task_error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> done_lock(done_mutex);
+        if (task_error && !error) error = task_error;
+        if (--remaining == 0) done_cv.notify_one();
+      });
+    }
+  }
+  cv_.notify_all();
+
+  std::unique_lock<std::mutex> lock(done_mutex);
+  done_cv.wait(lock, [&remaining]() { return remaining == 0; });
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+} // namespace ex_faiss
@@ -0,0 +1,50 @@
+#ifndef EX_FAISS_THREAD_POOL_H_
+#define EX_FAISS_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ex_faiss {
+
+// Fixed-size pool of worker threads shared by every caller, so
+// concurrent fan-out work from many schedulers is bounded by the
+// pool size rather than multiplied by it. Workers run Faiss with a
+// single OpenMP thread each, the pool itself provides parallelism.
+class ThreadPool {
+ public:
+  // Process-wide pool with one worker per hardware thread, started
+  // on first use. It is only destroyed by Shutdown, so workers
+  // outlive any static destructors that run at exit.
+  static ThreadPool& Get();
+
+  // Stops and joins the process-wide pool, if started. Must not be
+  // called while the pool is in use, i.e. only when unloading.
+  static void Shutdown();
+
+  explicit ThreadPool(int num_threads);
+  ~ThreadPool();
+
+  int num_threads() const { return workers_.size(); }
+
+  // Runs fn(i) for every i in [0, n) on the pool and blocks until
+  // all calls complete. The first exception thrown is rethrown on
+  // the calling thread. Must not be called from a pool worker.
+  void ParallelFor(int64_t n, const std::function<void(int64_t)>& fn);
+
+ private:
+  void WorkerLoop();
+
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_ = false;
+};
+
+} // namespace ex_faiss
+#endif
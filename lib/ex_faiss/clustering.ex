@@ -33,11 +33,11 @@ defmodule ExFaiss.Clustering do
       {^dim} ->
         # TODO: Warn?
         data = Nx.to_binary(tensor)
-        ExFaiss.NIF.train_clustering(clustering, 1, data, index)
+        ExFaiss.NIF.train_clustering(clustering, 1, data, index) |> unwrap!()
 
       {n, ^dim} ->
         data = Nx.to_binary(tensor)
-        ExFaiss.NIF.train_clustering(clustering, n, data, index)
+        ExFaiss.NIF.train_clustering(clustering, n, data, index) |> unwrap!()
 
       shape ->
         raise ArgumentError,
@@ -88,11 +88,11 @@ defmodule ExFaiss.Index do
     case Nx.shape(tensor) do
       {^dim} ->
         data = Nx.to_binary(tensor)
-        ExFaiss.NIF.add_to_index(ref, 1, data)
+        ExFaiss.NIF.add_to_index(ref, 1, data, :erlang.monotonic_time()) |> unwrap!()
 
       {n, ^dim} ->
         data = Nx.to_binary(tensor)
-        ExFaiss.NIF.add_to_index(ref, n, data)
+        ExFaiss.NIF.add_to_index(ref, n, data, :erlang.monotonic_time()) |> unwrap!()
 
       shape ->
         invalid_shape_error!(dim, shape)
@@ -112,12 +112,14 @@ defmodule ExFaiss.Index do
       {{^dim}, {1}} ->
         data = Nx.to_binary(tensor)
         xids = Nx.to_binary(ids)
-        ExFaiss.NIF.add_with_ids_to_index(ref, 1, data, xids)
+        ExFaiss.NIF.add_with_ids_to_index(ref, 1, data, xids, :erlang.monotonic_time())
+        |> unwrap!()
 
       {{n, ^dim}, {n}} ->
         data = Nx.to_binary(tensor)
         xids = Nx.to_binary(ids)
-        ExFaiss.NIF.add_with_ids_to_index(ref, n, data, xids)
+        ExFaiss.NIF.add_with_ids_to_index(ref, n, data, xids, :erlang.monotonic_time())
+        |> unwrap!()
 
       {tensor_shape, ids_shape} ->
         raise ArgumentError,
@@ -147,7 +149,8 @@ defmodule ExFaiss.Index do
     case Nx.shape(tensor) do
       {^dim} ->
         data = Nx.to_binary(tensor)
-        {distances, labels} = ExFaiss.NIF.search_index(index, 1, data, k) |> unwrap!()
+        {distances, labels} =
+          ExFaiss.NIF.search_index(index, 1, data, k, :erlang.monotonic_time()) |> unwrap!()
 
         %{
           distances: distances |> Nx.from_binary(:f32) |> Nx.reshape({1, k}),
@@ -156,7 +159,8 @@ defmodule ExFaiss.Index do
 
       {n, ^dim} ->
         data = Nx.to_binary(tensor)
-        {distances, labels} = ExFaiss.NIF.search_index(index, n, data, k) |> unwrap!()
+        {distances, labels} =
+          ExFaiss.NIF.search_index(index, n, data, k, :erlang.monotonic_time()) |> unwrap!()
 
         %{
           distances: distances |> Nx.from_binary(:f32) |> Nx.reshape({n, k}),
@@ -168,6 +172,66 @@ defmodule ExFaiss.Index do
     end
   end
 
+  @doc """
+  Searches several indices for the top `k` matches close
+  to the same query vectors in a single call.
+
+  The searches run in parallel on a native thread pool shared by
+  all callers, with one worker per core and each index searched by
+  a single worker, so latency is bound by the slowest index rather
+  than the sum. All indices must have the same dimensionality, and
+  the same metric when merging.
+
+  Returns a list with one result per index, in the same
+  shape as `search/3`.
+
+  ## Options
+
+    * `:merge` - when `true`, merges the results of all indices
+      into a single global top `k` per query. The result then
+      additionally has a `:tenants` key holding the position in
+      `indices` of the index each result came from, or `-1` if
+      fewer than `k` results were found. Defaults to `false`
+  """
+  def multi_search([%Index{dim: dim} | _] = indices, %Nx.Tensor{} = tensor, k, opts \\ [])
+      when is_integer(k) and k > 0 do
+    opts = Keyword.validate!(opts, merge: false)
+    validate_type!(tensor, {:f, 32})
+
+    n =
+      case Nx.shape(tensor) do
+        {^dim} -> 1
+        {n, ^dim} -> n
+        shape -> invalid_shape_error!(dim, shape)
+      end
+
+    refs = Enum.map(indices, & &1.ref)
+    merge = if opts[:merge], do: 1, else: 0
+    data = Nx.to_binary(tensor)
+
+    result =
+      refs
+      |> ExFaiss.NIF.multi_search_index(n, data, k, merge, :erlang.monotonic_time())
+      |> unwrap!()
+
+    case result do
+      {distances, labels, tenants} ->
+        %{
+          distances: distances |> Nx.from_binary(:f32) |> Nx.reshape({n, k}),
+          labels: labels |> Nx.from_binary(:s64) |> Nx.reshape({n, k}),
+          tenants: tenants |> Nx.from_binary(:s32) |> Nx.reshape({n, k})
+        }
+
+      results ->
+        Enum.map(results, fn {distances, labels} ->
+          %{
+            distances: distances |> Nx.from_binary(:f32) |> Nx.reshape({n, k}),
+            labels: labels |> Nx.from_binary(:s64) |> Nx.reshape({n, k})
+          }
+        end)
+    end
+  end
+
   @doc """
   Trains an index on a representative set of vectors.
   """
@@ -177,7 +241,7 @@ defmodule ExFaiss.Index do
     case Nx.shape(tensor) do
       {n, ^dim} ->
         data = Nx.to_binary(tensor)
-        ExFaiss.NIF.train_index(ref, n, data)
+        ExFaiss.NIF.train_index(ref, n, data, :erlang.monotonic_time()) |> unwrap!()
 
       shape ->
         invalid_shape_error!(dim, shape)
@@ -189,9 +253,34 @@ defmodule ExFaiss.Index do
   @doc """
   Creates a copy of the given index.
   """
-  def clone(%Index{dim: dim, ref: index}) do
+  def clone(%Index{dim: dim, ref: index, device: device}) do
     ref = ExFaiss.NIF.clone_index(index) |> unwrap!()
-    %Index{dim: dim, ref: ref}
+    %Index{dim: dim, ref: ref, device: device}
+  end
+
+  @doc """
+  Creates a read-only copy of the given index replicated
+  across the NUMA nodes of the host.
+
+  Each replica is allocated from a thread pinned to its node,
+  and searches are served by the replica local to the CPU of
+  the calling scheduler thread, so search throughput scales
+  across sockets instead of half the cores reading remote
+  memory. On hosts with a single NUMA node this is equivalent
+  to a read-only clone.
+
+  Adding to, training, resetting or autotuning a replicated
+  index raises, autotune the index before replicating it.
+  Search parameters set with `set_parameters/2` apply to all
+  replicas.
+  """
+  def replicate(%Index{dim: dim, ref: index, device: :host}) do
+    ref = ExFaiss.NIF.replicate_index(index) |> unwrap!()
+    %Index{dim: dim, ref: ref, device: :host}
+  end
+
+  def replicate(%Index{device: device}) do
+    raise ArgumentError, "only host indices can be replicated, got device #{inspect(device)}"
   end
 
   @doc """
@@ -210,7 +299,23 @@ defmodule ExFaiss.Index do
     keys_data = Nx.to_binary(keys)
 
     index
-    |> ExFaiss.NIF.reconstruct_batch_from_index(n, keys_data)
+    |> ExFaiss.NIF.reconstruct_batch_from_index(n, keys_data, :erlang.monotonic_time())
+    |> unwrap!()
+    |> Nx.from_binary(:f32)
+    |> Nx.reshape({n, dim})
+  end
+
+  @doc """
+  Reconstructs `n` stored vectors starting at position `i0`.
+
+  This is considerably faster than `reconstruct/2` for exporting
+  large contiguous ranges, as Flat and scalar quantizer indices
+  decode the whole range in a single pass.
+  """
+  def reconstruct_range(%Index{dim: dim, ref: index}, i0, n)
+      when is_integer(i0) and i0 >= 0 and is_integer(n) and n >= 0 do
+    index
+    |> ExFaiss.NIF.reconstruct_range_from_index(i0, n, :erlang.monotonic_time())
     |> unwrap!()
     |> Nx.from_binary(:f32)
     |> Nx.reshape({n, dim})
@@ -261,7 +366,7 @@ defmodule ExFaiss.Index do
   def from_file(fname, io_flags) do
     ref = ExFaiss.NIF.read_index(fname, io_flags) |> unwrap!()
     dim = ExFaiss.NIF.get_index_dim(ref) |> unwrap!()
-    %Index{dim: dim, ref: ref}
+    %Index{dim: dim, ref: ref, device: :host}
   end
 
   @doc """
@@ -271,6 +376,217 @@ defmodule ExFaiss.Index do
     ExFaiss.NIF.get_index_n_vectors(index) |> unwrap!()
   end
 
+  @doc """
+  Gets introspection and memory accounting information
+  about the index.
+
+  The result is a map with the following keys:
+
+    * `:class` - the concrete Faiss class of the index
+
+    * `:dim` - dimensionality of stored vectors
+
+    * `:n_vectors` - number of stored vectors
+
+    * `:replicas` - number of NUMA replicas, see `replicate/1`
+
+    * `:is_trained` - whether or not the index is trained
+
+    * `:metric` - metric type of the index
+
+    * `:sa_code_size` - size in bytes of a single encoded vector,
+      or `nil` if the index does not support standalone codes
+
+    * `:bytes` - serialized size of the index in bytes, which
+      approximates resident memory, or `nil` if the index cannot
+      be serialized (e.g. GPU indices). For replicated indices this
+      accounts for every replica
+
+    * `:ivf` - `nil` or a map with `:nlist`, `:nprobe`, `:imbalance_factor`
+      and `:list_sizes`, the min, max, p50, p90 and p99 inverted list lengths.
+      The imbalance factor is `0.0` while the index holds no vectors
+
+    * `:hnsw` - `nil` or a map with `:max_level`, `:entry_point`, `:ef_search`,
+      `:ef_construction` and `:levels`, the number of nodes on each level
+  """
+  def get_info(%Index{ref: index}) do
+    info = ExFaiss.NIF.get_index_info(index) |> unwrap!()
+    %{info | metric: int_to_metric_type(info.metric)}
+  end
+
+  @doc """
+  Searches for the index search parameters (such as `nprobe`
+  or `efSearch`) that best trade off latency and recall on the
+  given query vectors.
+
+  Returns `{index, frontier}` where `frontier` is the list of
+  Pareto-optimal operating points, ordered by increasing recall,
+  each a map with `:parameters`, `:recall` and `:seconds`, the time
+  taken to search all queries. `:recall` is the fraction of the
+  true top `k` results found in the top `k` results.
+
+  Exploration leaves the index set to the fastest point which
+  meets `:target_recall` or, if not given or unreachable, to the
+  point with the highest recall. Replicated indices can not be
+  autotuned, see `replicate/1`.
+
+  Ground truth must be given by one of the following options:
+
+    * `:ground_truth` - a `{n, gt_k}` `{:s, 64}` tensor with the
+      labels of the true nearest neighbors of each query, where
+      `gt_k >= k`
+
+    * `:reference` - an exact index (e.g. `"Flat"`) holding the
+      same vectors, which is searched to compute ground truth
+
+  ## Options
+
+    * `:k` - number of results to evaluate recall on. Defaults to `10`
+
+    * `:target_recall` - recall the index should meet
+
+    * `:max_experiments` - maximum number of parameter settings
+      to evaluate. Defaults to `500`
+  """
+  def autotune(%Index{dim: dim, ref: ref} = index, %Nx.Tensor{} = queries, opts \\ []) do
+    opts =
+      Keyword.validate!(opts, [
+        :ground_truth,
+        :reference,
+        :target_recall,
+        k: 10,
+        max_experiments: 500
+      ])
+
+    validate_type!(queries, {:f, 32})
+    k = opts[:k]
+
+    n =
+      case Nx.shape(queries) do
+        {n, ^dim} -> n
+        shape -> invalid_shape_error!(dim, shape)
+      end
+
+    ground_truth =
+      cond do
+        labels = opts[:ground_truth] ->
+          labels
+
+        reference = opts[:reference] ->
+          search(reference, queries, k).labels
+
+        true ->
+          raise ArgumentError, "one of :ground_truth or :reference must be given"
+      end
+
+    validate_type!(ground_truth, {:s, 64})
+
+    gt_k =
+      case Nx.shape(ground_truth) do
+        {^n, gt_k} when gt_k >= k ->
+          gt_k
+
+        shape ->
+          raise ArgumentError,
+                "invalid ground truth shape #{inspect(shape)}, expected" <>
+                  " {#{n}, gt_k} with gt_k >= #{k}"
+      end
+
+    frontier =
+      ref
+      |> ExFaiss.NIF.autotune_index(
+        n,
+        Nx.to_binary(queries),
+        k,
+        gt_k,
+        Nx.to_binary(ground_truth),
+        opts[:max_experiments]
+      )
+      |> unwrap!()
+
+    target = opts[:target_recall]
+    point = (target && Enum.find(frontier, &(&1.recall >= target))) || List.last(frontier)
+
+    if point do
+      set_parameters(index, point.parameters)
+    end
+
+    {index, frontier}
+  end
+
+  @doc """
+  Sets index search parameters from a Faiss parameter
+  string, such as `"nprobe=16,efSearch=64"`.
+  """
+  def set_parameters(%Index{ref: ref} = index, parameters) when is_binary(parameters) do
+    ExFaiss.NIF.set_index_parameters(ref, parameters) |> unwrap!()
+    index
+  end
+
+  @doc """
+  Enables a native LRU cache of search results on the index,
+  holding up to `capacity` results of single query vectors.
+  A `capacity` of `0` disables the cache.
+
+  Results are cached per query vector and `k`. Adding to,
+  training or resetting the index, training a clustering with
+  it, as well as changing its search parameters, invalidates
+  all cached results.
+
+  Calling this again clears the cache and its statistics. It
+  is safe to do while other processes search the index.
+  """
+  def set_cache(%Index{ref: ref} = index, capacity)
+      when is_integer(capacity) and capacity >= 0 do
+    ExFaiss.NIF.set_index_cache(ref, capacity) |> unwrap!()
+    index
+  end
+
+  @doc """
+  Gets statistics of the search result cache of the index.
+
+  Returns `nil` if the cache is disabled, otherwise a map with
+  `:capacity`, `:size`, `:hits`, `:misses` and `:evictions`.
+  """
+  def get_cache_stats(%Index{ref: ref}) do
+    ExFaiss.NIF.get_index_cache_stats(ref) |> unwrap!()
+  end
+
+  @doc """
+  Gets native instrumentation counters of the index.
+
+  The result is a map with keys `:add`, `:search`, `:train`
+  and `:reconstruct`, each containing the number of vectors
+  processed under `:items` and two latency histograms: `:exec`,
+  the time spent executing natively (including search result
+  cache lookups), and `:wait`, the time between
+  the call being issued and Faiss starting to execute it, which
+  is dominated by dirty scheduler queueing.
+
+  Each histogram has a `:count`, a `:total_ns` and `:buckets`,
+  a list where the bucket at position `i` counts the calls
+  which took between `2^i` and `2^(i+1)` nanoseconds.
+
+  Additionally `:ivf` and `:hnsw` contain Faiss' internal search
+  counters (such as the number of distance computations `:ndis`)
+  accumulated over searches on this index. Faiss keeps these
+  counters process-wide, so they are approximate when other
+  indices are searched concurrently. Searches issued through
+  `multi_search/4` are not counted there, since they always run
+  concurrently with each other.
+  """
+  def get_stats(%Index{ref: index}) do
+    ExFaiss.NIF.get_index_stats(index) |> unwrap!()
+  end
+
+  @doc """
+  Resets native instrumentation counters of the index.
+  """
+  def reset_stats(%Index{ref: ref} = index) do
+    :ok = ExFaiss.NIF.reset_index_stats(ref)
+    index
+  end
+
   defp invalid_shape_error!(dim, shape) do
     raise ArgumentError,
           "invalid shape for index with dim #{inspect(dim)}," <>
@@ -288,4 +604,13 @@ defmodule ExFaiss.Index do
   defp metric_type_to_int(:braycurtis), do: 21
   defp metric_type_to_int(:jensenshannon), do: 22
   defp metric_type_to_int(invalid), do: raise(ArgumentError, "invalid metric #{inspect(invalid)}")
+
+  defp int_to_metric_type(0), do: :inner_product
+  defp int_to_metric_type(1), do: :l2
+  defp int_to_metric_type(2), do: :l1
+  defp int_to_metric_type(3), do: :linf
+  defp int_to_metric_type(4), do: :lp
+  defp int_to_metric_type(20), do: :canberra
+  defp int_to_metric_type(21), do: :braycurtis
+  defp int_to_metric_type(22), do: :jensenshannon
 end
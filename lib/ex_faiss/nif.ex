@@ -9,17 +9,40 @@ defmodule ExFaiss.NIF do
   # Index operations
   def new_index(_dim, _description, _metric), do: :erlang.nif_error(:undef)
   def clone_index(_index), do: :erlang.nif_error(:undef)
-  def add_to_index(_index, _dim, _data), do: :erlang.nif_error(:undef)
-  def add_with_ids_to_index(_index, _dim, _data, _ids), do: :erlang.nif_error(:undef)
-  def search_index(_index, _n, _data, _k), do: :erlang.nif_error(:undef)
-  def train_index(_index, _n, _data), do: :erlang.nif_error(:undef)
+  def replicate_index(_index), do: :erlang.nif_error(:undef)
+  def add_to_index(_index, _dim, _data, _enqueued_at), do: :erlang.nif_error(:undef)
+
+  def add_with_ids_to_index(_index, _dim, _data, _ids, _enqueued_at),
+    do: :erlang.nif_error(:undef)
+
+  def search_index(_index, _n, _data, _k, _enqueued_at), do: :erlang.nif_error(:undef)
+  def multi_search_index(_indices, _n, _data, _k, _merge, _enqueued_at),
+    do: :erlang.nif_error(:undef)
+
+  def train_index(_index, _n, _data, _enqueued_at), do: :erlang.nif_error(:undef)
   def reset_index(_index), do: :erlang.nif_error(:undef)
-  def reconstruct_batch_from_index(_index, _n, _data), do: :erlang.nif_error(:undef)
+
+  def reconstruct_batch_from_index(_index, _n, _data, _enqueued_at),
+    do: :erlang.nif_error(:undef)
+
+  def reconstruct_range_from_index(_index, _i0, _n, _enqueued_at),
+    do: :erlang.nif_error(:undef)
+
   def compute_residuals_from_index(_index, _n, _data, _keys), do: :erlang.nif_error(:undef)
   def write_index(_index, _fname), do: :erlang.nif_error(:undef)
   def read_index(_fname, _io_flags), do: :erlang.nif_error(:undef)
   def get_index_dim(_index), do: :erlang.nif_error(:undef)
   def get_index_n_vectors(_index), do: :erlang.nif_error(:undef)
+  def get_index_info(_index), do: :erlang.nif_error(:undef)
+  def get_index_stats(_index), do: :erlang.nif_error(:undef)
+  def reset_index_stats(_index), do: :erlang.nif_error(:undef)
+
+  def autotune_index(_index, _n, _data, _k, _gt_k, _gt_labels, _max_experiments),
+    do: :erlang.nif_error(:undef)
+
+  def set_index_parameters(_index, _parameters), do: :erlang.nif_error(:undef)
+  def set_index_cache(_index, _capacity), do: :erlang.nif_error(:undef)
+  def get_index_cache_stats(_index), do: :erlang.nif_error(:undef)
 
   # Gpu operations
   def index_cpu_to_gpu(_index, _device), do: :erlang.nif_error(:undef)
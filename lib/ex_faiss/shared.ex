@@ -9,6 +9,7 @@ defmodule ExFaiss.Shared do
     end
   end
 
+  def unwrap!(:ok), do: :ok
   def unwrap!({:ok, val}), do: val
-  def unwrap!({:error, reason}), do: raise(reason)
+  def unwrap!({:error, reason}), do: raise(to_string(reason))
 end
@@ -19,5 +19,29 @@ defmodule ExFaiss.ClusteringTest do
       assert %Clustering{k: 10, ref: _, index: %Index{dim: 128} = index} = trained
       assert Index.get_num_vectors(index) == 10
     end
+
+    test "invalidates cached search results on the index" do
+      clustering = Clustering.new(1, 1)
+      Index.set_cache(clustering.index, 16)
+      query = Nx.tensor([0.0])
+
+      clustering = Clustering.train(clustering, Nx.broadcast(0.0, {64, 1}))
+      assert %{distances: distances} = Index.search(clustering.index, query, 1)
+      assert distances == Nx.tensor([[0.0]])
+
+      clustering = Clustering.train(clustering, Nx.broadcast(2.0, {64, 1}))
+      assert %{distances: distances} = Index.search(clustering.index, query, 1)
+      assert distances == Nx.tensor([[4.0]])
+      assert %{hits: 0, misses: 2} = Index.get_cache_stats(clustering.index)
+    end
+
+    test "raises on replicated indices" do
+      clustering = Clustering.new(128, 10)
+      clustering = %{clustering | index: Index.replicate(clustering.index)}
+
+      assert_raise RuntimeError, ~r/read-only/, fn ->
+        Clustering.train(clustering, Nx.random_uniform({100, 128}))
+      end
+    end
   end
 end
@@ -46,6 +46,44 @@ defmodule ExFaiss.IndexTest do
     end
   end
 
+  describe "replicate" do
+    test "creates a read-only replicated index" do
+      data = Nx.iota({64, 1}, type: :f32)
+
+      index =
+        ExFaiss.Index.new(1, "Flat", metric: :l1)
+        |> ExFaiss.Index.add(data)
+        |> ExFaiss.Index.replicate()
+
+      assert %{labels: labels} = ExFaiss.Index.search(index, Nx.tensor([0.0]), 4)
+      assert labels == Nx.iota({1, 4})
+      assert %{replicas: replicas} = ExFaiss.Index.get_info(index)
+      assert replicas >= 1
+
+      assert_raise RuntimeError, ~r/read-only/, fn ->
+        ExFaiss.Index.add(index, data)
+      end
+
+      assert_raise RuntimeError, ~r/read-only/, fn ->
+        ExFaiss.Index.autotune(index, Nx.tensor([[0.0]]), k: 1, ground_truth: Nx.tensor([[0]]))
+      end
+    end
+
+    @tag :tmp_dir
+    test "replicates an index read from a file", %{tmp_dir: tmp_dir} do
+      path = Path.join(tmp_dir, "index.faiss")
+
+      ExFaiss.Index.new(1, "Flat", metric: :l1)
+      |> ExFaiss.Index.add(Nx.iota({64, 1}, type: :f32))
+      |> ExFaiss.Index.to_file(path)
+
+      index = ExFaiss.Index.from_file(path, 0) |> ExFaiss.Index.replicate()
+
+      assert %{labels: labels} = ExFaiss.Index.search(index, Nx.tensor([0.0]), 4)
+      assert labels == Nx.iota({1, 4})
+    end
+  end
+
   describe "add" do
     test "adds valid tensors" do
       index = ExFaiss.Index.new(512, "Flat")
@@ -110,6 +148,51 @@ defmodule ExFaiss.IndexTest do
     end
   end
 
+  describe "multi_search" do
+    test "searches several indices at once" do
+      index1 =
+        ExFaiss.Index.new(1, "Flat", metric: :l1)
+        |> ExFaiss.Index.add(Nx.iota({8, 1}, type: :f32))
+
+      index2 =
+        ExFaiss.Index.new(1, "Flat", metric: :l1)
+        |> ExFaiss.Index.add(Nx.add(Nx.iota({8, 1}, type: :f32), 0.5))
+
+      assert [%{labels: labels1}, %{labels: labels2, distances: distances2}] =
+               ExFaiss.Index.multi_search([index1, index2], Nx.tensor([0.0]), 2)
+
+      assert labels1 == Nx.tensor([[0, 1]])
+      assert labels2 == Nx.tensor([[0, 1]])
+      assert distances2 == Nx.tensor([[0.5, 1.5]])
+    end
+
+    test "merges results into a global top k" do
+      index1 =
+        ExFaiss.Index.new(1, "Flat", metric: :l1)
+        |> ExFaiss.Index.add(Nx.iota({8, 1}, type: :f32))
+
+      index2 =
+        ExFaiss.Index.new(1, "Flat", metric: :l1)
+        |> ExFaiss.Index.add(Nx.add(Nx.iota({8, 1}, type: :f32), 0.5))
+
+      assert %{distances: distances, labels: labels, tenants: tenants} =
+               ExFaiss.Index.multi_search([index1, index2], Nx.tensor([0.0]), 3, merge: true)
+
+      assert distances == Nx.tensor([[0.0, 0.5, 1.0]])
+      assert labels == Nx.tensor([[0, 0, 1]])
+      assert tenants == Nx.tensor([[0, 1, 0]], type: :s32)
+    end
+
+    test "refuses to merge indices with different metrics" do
+      index1 = ExFaiss.Index.new(1, "Flat", metric: :l1) |> ExFaiss.Index.add(Nx.tensor([[0.0]]))
+      index2 = ExFaiss.Index.new(1, "Flat", metric: :l2) |> ExFaiss.Index.add(Nx.tensor([[0.0]]))
+
+      assert_raise RuntimeError, ~r/same metric/, fn ->
+        ExFaiss.Index.multi_search([index1, index2], Nx.tensor([0.0]), 1, merge: true)
+      end
+    end
+  end
+
   describe "train" do
     test "trains an index" do
       index =
@@ -144,6 +227,29 @@ defmodule ExFaiss.IndexTest do
     end
   end
 
+  describe "reconstruct_range" do
+    test "reconstructs a contiguous range of vectors" do
+      data = Nx.random_uniform({10, 128})
+
+      result =
+        ExFaiss.Index.new(128, "Flat")
+        |> ExFaiss.Index.add(data)
+        |> ExFaiss.Index.reconstruct_range(2, 5)
+
+      assert result == data[2..6]
+    end
+
+    test "raises on out of bounds ranges" do
+      index =
+        ExFaiss.Index.new(128, "Flat")
+        |> ExFaiss.Index.add(Nx.random_uniform({10, 128}))
+
+      assert_raise RuntimeError, ~r/out of bounds/, fn ->
+        ExFaiss.Index.reconstruct_range(index, 8, 5)
+      end
+    end
+  end
+
   describe "compute_residuals" do
     test "computes residuals from data and keys" do
       data = Nx.broadcast(0.0, {1, 128})
@@ -157,6 +263,177 @@ defmodule ExFaiss.IndexTest do
     end
   end
 
+  describe "get_info" do
+    test "describes a flat index" do
+      index =
+        ExFaiss.Index.new(128, "Flat")
+        |> ExFaiss.Index.add(Nx.random_uniform({10, 128}))
+
+      assert %{
+               class: "faiss::IndexFlat" <> _,
+               dim: 128,
+               n_vectors: 10,
+               is_trained: true,
+               metric: :l2,
+               sa_code_size: 512,
+               ivf: nil,
+               hnsw: nil
+             } = ExFaiss.Index.get_info(index)
+    end
+
+    test "describes ivf inverted lists" do
+      data = Nx.random_uniform({200, 10})
+
+      index =
+        ExFaiss.Index.new(10, "IVF4,Flat")
+        |> ExFaiss.Index.train(data)
+        |> ExFaiss.Index.add(data)
+
+      assert %{is_trained: true, ivf: %{nlist: 4, nprobe: 1, list_sizes: sizes}} =
+               ExFaiss.Index.get_info(index)
+
+      assert sizes.min <= sizes.p50 and sizes.p50 <= sizes.max
+    end
+
+    test "describes empty ivf inverted lists" do
+      index =
+        ExFaiss.Index.new(10, "IVF4,Flat")
+        |> ExFaiss.Index.train(Nx.random_uniform({200, 10}))
+
+      assert %{n_vectors: 0, ivf: %{imbalance_factor: 0.0, list_sizes: %{max: 0}}} =
+               ExFaiss.Index.get_info(index)
+    end
+
+    test "describes hnsw levels" do
+      index =
+        ExFaiss.Index.new(10, "HNSW,Flat")
+        |> ExFaiss.Index.add(Nx.random_uniform({100, 10}))
+
+      assert %{hnsw: %{levels: [100 | _]}} = ExFaiss.Index.get_info(index)
+    end
+  end
+
+  describe "autotune" do
+    test "explores search parameters against a reference index" do
+      data = Nx.random_uniform({1000, 10})
+      queries = Nx.random_uniform({50, 10})
+
+      reference = ExFaiss.Index.new(10, "Flat") |> ExFaiss.Index.add(data)
+
+      index =
+        ExFaiss.Index.new(10, "IVF16,Flat")
+        |> ExFaiss.Index.train(data)
+        |> ExFaiss.Index.add(data)
+
+      assert {%Index{}, [_ | _] = frontier} =
+               ExFaiss.Index.autotune(index, queries, reference: reference, target_recall: 0.9)
+
+      assert Enum.all?(frontier, &(is_binary(&1.parameters) and &1.recall <= 1.0))
+
+      point =
+        case Enum.find(frontier, &(&1.recall >= 0.9)) do
+          nil -> List.last(frontier)
+          point -> point
+        end
+
+      assert [_, expected] = Regex.run(~r/nprobe=(\d+)/, point.parameters)
+      assert %{ivf: %{nprobe: nprobe}} = ExFaiss.Index.get_info(index)
+      assert nprobe == String.to_integer(expected)
+    end
+
+    test "raises without ground truth" do
+      index = ExFaiss.Index.new(10, "Flat")
+
+      assert_raise ArgumentError, ~r/:ground_truth or :reference/, fn ->
+        ExFaiss.Index.autotune(index, Nx.random_uniform({5, 10}))
+      end
+    end
+  end
+
+  describe "set_cache" do
+    test "serves repeated queries from the cache" do
+      index =
+        ExFaiss.Index.new(1, "Flat", metric: :l1)
+        |> ExFaiss.Index.add(Nx.iota({64, 1}, type: :f32))
+        |> ExFaiss.Index.set_cache(16)
+
+      query = Nx.tensor([[0.0], [1.0]])
+
+      assert %{labels: labels} = ExFaiss.Index.search(index, query, 2)
+      assert %{labels: ^labels} = ExFaiss.Index.search(index, query, 2)
+      assert %{hits: 2, misses: 2, size: 2} = ExFaiss.Index.get_cache_stats(index)
+    end
+
+    test "invalidates cached results on add" do
+      index =
+        ExFaiss.Index.new(1, "Flat", metric: :l1)
+        |> ExFaiss.Index.add(Nx.tensor([[1.0]]))
+        |> ExFaiss.Index.set_cache(16)
+
+      query = Nx.tensor([0.0])
+
+      assert %{labels: labels} = ExFaiss.Index.search(index, query, 1)
+      assert labels == Nx.tensor([[0]])
+
+      ExFaiss.Index.add(index, Nx.tensor([[0.0]]))
+
+      assert %{labels: labels} = ExFaiss.Index.search(index, query, 1)
+      assert labels == Nx.tensor([[1]])
+      assert %{hits: 0, misses: 2} = ExFaiss.Index.get_cache_stats(index)
+    end
+
+    test "returns nil stats when disabled" do
+      assert ExFaiss.Index.new(1, "Flat") |> ExFaiss.Index.get_cache_stats() == nil
+    end
+
+    test "can be toggled while the index is searched" do
+      index =
+        ExFaiss.Index.new(1, "Flat", metric: :l1)
+        |> ExFaiss.Index.add(Nx.iota({64, 1}, type: :f32))
+
+      searches =
+        Task.async_stream(1..200, fn i ->
+          query = Nx.tensor([[rem(i, 64) * 1.0]])
+          ExFaiss.Index.search(index, query, 1).labels
+        end)
+
+      toggles =
+        Task.async(fn ->
+          for capacity <- Stream.cycle([0, 8, 64]) |> Enum.take(300) do
+            ExFaiss.Index.set_cache(index, capacity)
+          end
+        end)
+
+      for {{:ok, labels}, i} <- Enum.zip(searches, 1..200) do
+        assert labels == Nx.tensor([[rem(i, 64)]])
+      end
+
+      Task.await(toggles)
+      assert %{capacity: 64} = ExFaiss.Index.get_cache_stats(index)
+    end
+  end
+
+  describe "get_stats" do
+    test "counts operations on the index" do
+      index =
+        ExFaiss.Index.new(10, "Flat")
+        |> ExFaiss.Index.add(Nx.random_uniform({100, 10}))
+
+      ExFaiss.Index.search(index, Nx.random_uniform({5, 10}), 3)
+
+      assert %{
+               add: %{items: 100, exec: %{count: 1}, wait: %{count: 1}},
+               search: %{items: 5, exec: %{count: 1, buckets: buckets}},
+               train: %{items: 0}
+             } = ExFaiss.Index.get_stats(index)
+
+      assert Enum.sum(buckets) == 1
+
+      assert %{add: %{items: 0}, search: %{items: 0}} =
+               index |> ExFaiss.Index.reset_stats() |> ExFaiss.Index.get_stats()
+    end
+  end
+
   describe "memory" do
     @tag :slow
     test "does not leak" do